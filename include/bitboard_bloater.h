@@ -0,0 +1,195 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+
+#include "grid.h"
+#include "identifiable.h"
+#include "simulator.h"
+
+// Bit-parallel StraightBloat/ChebyshevBloat. Tiles are packed 64 to a word, every step dilates each seed's frontier
+// by a cross or a 3x3 box with shifts and ORs, and masks it with a shared claimed plane.
+// Only the frontier words are kept and visited, so a step costs about its frontier size / 64 word operations
+// plus one setTile per claimed tile.
+// Every seed tile keeps its own frontier and the seeds claim in raster order, each one masking the tiles
+// of the seeds before it. A tile reached by several seeds in the same step goes to the seed first in raster order
+// as in ZoneBloater, whose frontier stays grouped by seed in that order, so the grid and the step count are the same.
+template <typename T>
+class BitboardBloater : public Simulator{
+    public:
+        enum class Kernel{
+            cross, // StraightBloat
+            box    // ChebyshevBloat
+        };
+
+        //Empty grid tiles are considered NullID
+        void initVoronoi(std::shared_ptr<Grid<T>> initialGrid, Kernel kernel = Kernel::cross);
+        void onStart() override;
+        void onStep() override;
+        void onReset() override;
+        void finishAndReset();
+
+        std::shared_ptr<Grid<T>> getGrid() const;
+
+    private:
+        struct FrontierWord{
+            int index; // row * wordsPerRow + word
+            uint64_t bits;
+        };
+        struct Seed{
+            Identifiable zoneID;
+            std::vector<FrontierWord> frontier;
+        };
+
+        void dilate(const FrontierWord& word);
+        void orInto(int index, uint64_t bits);
+        void claim(Seed& seed);
+
+        std::shared_ptr<Grid<T>> grid;
+        Kernel kernel = Kernel::cross;
+        int wordsPerRow = 0;
+        int height = 0;
+        uint64_t lastWordMask = 0;
+
+        std::vector<uint64_t> claimed;
+        // Seed tiles in raster order, which is the claim priority within a step. Seeds are dropped once their frontier is empty.
+        std::vector<Seed> seeds;
+        // Dilated bits of the seed being stepped, zero outside of it
+        std::vector<uint64_t> scratch;
+        std::vector<int> touched;
+        std::vector<FrontierWord> nextFrontier;
+};
+
+template <typename T>
+void BitboardBloater<T>::initVoronoi(std::shared_ptr<Grid<T>> initialGrid, Kernel kernel){
+    grid = initialGrid;
+    this->kernel = kernel;
+    int width = grid->getWidth();
+    height = grid->getHeight();
+    wordsPerRow = (width + 63) / 64;
+    lastWordMask = width % 64 == 0 ? ~uint64_t{0} : (uint64_t{1} << (width % 64)) - 1;
+    claimed.assign(static_cast<size_t>(wordsPerRow) * height, 0);
+    scratch.assign(claimed.size(), 0);
+    seeds.clear();
+
+    for (auto it = grid->begin(); it != grid->end(); ++it){
+        if (*it == Identifiable::nullID){
+            continue;
+        }
+        int index = it.getY() * wordsPerRow + it.getX() / 64;
+        uint64_t bit = uint64_t{1} << (it.getX() % 64);
+        seeds.push_back(Seed{*it, {FrontierWord{index, bit}}});
+        claimed[index] |= bit;
+    }
+}
+
+template <typename T>
+void BitboardBloater<T>::onStart(){
+    if (!grid){
+        finish();
+        throw std::invalid_argument("No grid is set!");
+    }
+}
+
+template <typename T>
+void BitboardBloater<T>::onStep(){
+    size_t growing = 0;
+    for (Seed& seed : seeds){
+        for (const FrontierWord& word : seed.frontier){
+            dilate(word);
+        }
+        claim(seed);
+        if (!seed.frontier.empty()){
+            if (&seeds[growing] != &seed)
+                seeds[growing] = std::move(seed);
+            growing++;
+        }
+    }
+    seeds.resize(growing);
+    if (seeds.empty())
+        finish();
+}
+
+template <typename T>
+void BitboardBloater<T>::onReset(){
+    seeds.clear();
+    claimed.clear();
+    scratch.clear();
+    touched.clear();
+    nextFrontier.clear();
+}
+
+template <typename T>
+void BitboardBloater<T>::finishAndReset(){
+    if (isRunning())
+        finish();
+    if (isFinished())
+        reset();
+}
+
+template <typename T>
+std::shared_ptr<Grid<T>> BitboardBloater<T>::getGrid() const{
+    return grid;
+}
+
+// Bit b of word j is the tile x = 64 * j + b, so moving a tile left or right is a shift with a carry into the next word.
+template <typename T>
+void BitboardBloater<T>::dilate(const FrontierWord& word){
+    int row = word.index / wordsPerRow;
+    int column = word.index % wordsPerRow;
+    uint64_t bits = word.bits;
+    uint64_t horizontal = bits | (bits << 1) | (bits >> 1);
+    uint64_t intoLeft = column > 0 ? bits << 63 : 0;
+    uint64_t intoRight = column + 1 < wordsPerRow ? bits >> 63 : 0;
+    uint64_t vertical = kernel == Kernel::box ? horizontal : bits;
+
+    for (int dy = -1; dy <= 1; dy++){
+        int y = row + dy;
+        if (y < 0 || y >= height){
+            continue;
+        }
+        int index = word.index + dy * wordsPerRow;
+        orInto(index, dy == 0 ? horizontal : vertical);
+        if (dy == 0 || kernel == Kernel::box){
+            if (intoLeft)
+                orInto(index - 1, intoLeft);
+            if (intoRight)
+                orInto(index + 1, intoRight);
+        }
+    }
+}
+
+template <typename T>
+void BitboardBloater<T>::orInto(int index, uint64_t bits){
+    if (scratch[index] == 0){
+        touched.push_back(index);
+    }
+    scratch[index] |= bits;
+}
+
+template <typename T>
+void BitboardBloater<T>::claim(Seed& seed){
+    nextFrontier.clear();
+    for (int index : touched){
+        uint64_t bits = scratch[index] & ~claimed[index];
+        scratch[index] = 0;
+        if (index % wordsPerRow == wordsPerRow - 1){
+            bits &= lastWordMask;
+        }
+        if (!bits){
+            continue;
+        }
+        claimed[index] |= bits;
+        nextFrontier.push_back({index, bits});
+        int y = index / wordsPerRow;
+        int xBase = index % wordsPerRow * 64;
+        for (uint64_t rest = bits; rest; rest &= rest - 1){
+            grid->setTile(xBase + std::countr_zero(rest), y, seed.zoneID);
+        }
+    }
+    touched.clear();
+    seed.frontier.swap(nextFrontier);
+}
@@ -2,21 +2,75 @@
 
 #include <vector>
 #include <queue>
+#include <span>
 
 #include "identifiable.h"
+#include "id_map.h"
 #include "matrix.h"
 #include "grid.h"
 #include "radial.h"
 #include "edge_graph.h"
 #include "connection.h"
+#include "connection_table.h"
 #include "border.h"
+#include "generator.h"
+#include "stage_progress.h"
 
 struct ZoneMasks{
     // Used to determine increased/decreased power of tiles, for example for resources.
-    std::unordered_map<Identifiable, Matrix<double>, IDHash> bonusMask;
+    IDMap<Matrix<double>> bonusMask;
 
      // Used to determine how much imapct this zone has on the tile. Each tile is supposed to have 0.0 or 1.0 sum of all zones influences.
-    std::unordered_map<Identifiable, Matrix<double>, IDHash> influenceMask;
+    IDMap<Matrix<double>> influenceMask;
+};
+
+struct ZoneWeight{
+    Identifiable zone;
+    double weight;
+};
+
+// ZoneMasks keeping only the nonzero values: the influences of each tile as a row of (zone, weight) pairs, and one bonus
+// per tile, which belongs to the zone the tile has after the intake. Memory is proportional to the tiles and the
+// blended band around the borders instead of the zones times the tiles.
+class SparseZoneMasks{
+    public:
+        SparseZoneMasks() = default;
+        SparseZoneMasks(
+                int width,
+                int height,
+                std::vector<Identifiable> zoneIDs,
+                std::vector<Identifiable> tileZones,
+                std::vector<double> bonuses,
+                std::vector<size_t> influenceOffsets,
+                std::vector<ZoneWeight> influences
+            );
+
+        int getWidth() const{return width;};
+        int getHeight() const{return height;};
+        // Template zones in ascending ID order
+        const std::vector<Identifiable>& getZoneIDs() const{return zoneIDs;};
+        // Zone of the tile after the intake, nullID for empty tiles
+        Identifiable getZone(int x, int y) const;
+        // Nonzero influences of the tile in ascending zone ID order, empty tiles have none.
+        std::span<const ZoneWeight> getInfluences(int x, int y) const;
+        double getInfluence(Identifiable zone, int x, int y) const;
+        double getBonus(Identifiable zone, int x, int y) const;
+        size_t getInfluenceCount() const{return influences.size();};
+
+        // The per-zone matrices blendConnections returns for the same grid and template.
+        ZoneMasks toZoneMasks() const;
+
+    private:
+        size_t getTileIndex(int x, int y) const;
+
+        int width = 0;
+        int height = 0;
+        std::vector<Identifiable> zoneIDs;
+        std::vector<Identifiable> tileZones;
+        std::vector<double> bonuses;
+        // Influences of tile y * width + x are from influenceOffsets[tile] to influenceOffsets[tile + 1]
+        std::vector<size_t> influenceOffsets;
+        std::vector<ZoneWeight> influences;
 };
 
 struct BFSIntakeElement{
@@ -40,54 +94,106 @@ struct BFSGuarantorElement{
     double weightSpread;
 };
 
+using BasicConnectionTable = ConnectionTable<BasicSymConnection, BasicAsymConnection>;
+
 template <typename T>
 ZoneMasks blendConnections(const Grid<T>& grid, const EdgeGraph<T, BasicSymConnection, BasicAsymConnection>& mapTemplate);
 
+// blendConnections as a generator which writes the masks to result when it returns. It yields after the border
+// tracing, every blendYieldInterval queue elements, after every row of the scans, after every allocated
+// per-zone matrix and after each phase.
+// grid and mapTemplate must outlive it.
+template <typename T>
+Generator<StageProgress> blendConnectionsStaged(const Grid<T>& grid, const EdgeGraph<T, BasicSymConnection, BasicAsymConnection>& mapTemplate, ZoneMasks& result);
+constexpr long long blendYieldInterval = 4096;
+
+// Same result as blendConnections without a matrix per zone. The zones are kept in one label buffer, the seeds
+// of the guarantor and blend queues are found by one pass over it, the bonuses are one value per tile and
+// the blend influences are kept only for the tiles the blend reaches.
+template <typename T>
+SparseZoneMasks blendConnectionsSparse(const Grid<T>& grid, const EdgeGraph<T, BasicSymConnection, BasicAsymConnection>& mapTemplate);
+// blendConnectionsSparse as a generator, yielding as blendConnectionsStaged does but after every row of the scans.
+template <typename T>
+Generator<StageProgress> blendConnectionsSparseStaged(const Grid<T>& grid, const EdgeGraph<T, BasicSymConnection, BasicAsymConnection>& mapTemplate, SparseZoneMasks& result);
+// The part of blendConnectionsSparseStaged after the border tracing. labels has the zone ID of each tile (y * width + x),
+// every zone other than nullID has to be in connections.
+Generator<StageProgress> blendLabelsSparseStaged(
+        std::vector<int> labels,
+        int width,
+        int height,
+        BasicConnectionTable connections,
+        std::queue<BFSIntakeElement> bfsIntakeQueue,
+        SparseZoneMasks& result
+    );
+
+// The intake queue seeds, the zone tiles along the borders of each asym edge.
+template <typename T>
+std::queue<BFSIntakeElement> startIntakeQueue(
+        const Grid<T>& grid,
+        const EdgeGraph<T, BasicSymConnection, BasicAsymConnection>& mapTemplate,
+        const std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<tiles::Border>, PairIDHash>& borders
+    );
+
+// Seed the guarantor and blend queues from a tile of neighbourZone (spreadingZone) next to coords.
+// zoneLabels has the zone of each tile after the intake, so the zone at coords is one lookup.
+void tryAddToBFSGuarantorQueue(
+        std::vector<BFSGuarantorElement>& guarantorSeeds,
+        IntVector2 coords,
+        Identifiable neighbourZone,
+        const Matrix<Identifiable>& zoneLabels,
+        const BasicConnectionTable& connections
+    );
+
 void tryAddToBFSBlendQueue(
-        std::queue<BFSBlendElement>& bfsBlendQueue,
+        std::vector<BFSBlendElement>& blendSeeds,
         IntVector2 coords,
         Identifiable spreadingZone,
-        const std::unordered_map<Identifiable, Matrix<double>, IDHash>& matrices,
-        const std::unordered_map<std::pair<Identifiable, Identifiable>, BasicSymConnection, PairIDHash>& symEdges
+        const Matrix<Identifiable>& zoneLabels,
+        const BasicConnectionTable& connections
     );
 
 template <typename T>
-std::unordered_map<Identifiable, Matrix<double>, IDHash> buildZoneMasks(const Grid<T>& grid);
+IDMap<Matrix<double>> buildZoneMasks(const Grid<T>& grid);
+// buildZoneMasks into result, yielding after each allocated mask and each row.
+template <typename T>
+Generator<StageProgress> buildZoneMasksStaged(const Grid<T>& grid, IDMap<Matrix<double>>& result);
 
 
 
 template <typename T>
 inline ZoneMasks blendConnections(const Grid<T>& grid, const EdgeGraph<T, BasicSymConnection, BasicAsymConnection>& mapTemplate)
 {
-    std::unordered_map<Identifiable, Matrix<double>, IDHash> zoneInfluence = buildZoneMasks(grid);
+    ZoneMasks result;
+    for (Generator<StageProgress> blending = blendConnectionsStaged(grid, mapTemplate, result); blending.next();){}
+    return result;
+}
 
-    std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<tiles::Border>, PairIDHash> borders = tiles::Border::getAllBorders(grid);
-    std::queue<BFSIntakeElement> bfsIntakeQueue;
-    const auto& asymEdges = mapTemplate.getAsymEdges();
-    for (auto& [idPair, asymEdgeParams] : asymEdges){
-        auto reversedIdPair = std::make_pair(idPair.second, idPair.first);
-        auto it = borders.find(idPair);
-        auto reversedIt = borders.find(reversedIdPair);
-        if (it == borders.end()){
-            it = reversedIt;
-            if (reversedIt == borders.end()){
-                continue; //No border found between these zones
-            }
-        }
-        for (tiles::Border border : it->second){
-            bool leftOriented = grid.getTileID(border.getLeft(0)) == idPair.first;
-            for (tiles::Border::Segment segment : border.getSegments()){
-                bfsIntakeQueue.push({
-                    leftOriented? segment.getLeftPos() : segment.getRightPos(),
-                    idPair.first,
-                    idPair.second,
-                    asymEdgeParams.intakeDistance
-                });
-            }
+template <typename T>
+Generator<StageProgress> blendConnectionsStaged(const Grid<T>& grid, const EdgeGraph<T, BasicSymConnection, BasicAsymConnection>& mapTemplate, ZoneMasks& result)
+{
+    IDMap<Matrix<double>> zoneInfluence;
+    for (Generator<StageProgress> building = buildZoneMasksStaged(grid, zoneInfluence); building.next();){
+        co_yield building.value();
+    }
+    BasicConnectionTable connections(mapTemplate);
+
+    std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<tiles::Border>, PairIDHash> borders;
+    for (Generator<StageProgress> tracing = tiles::Border::traceAllBorders(grid, borders); tracing.next();){
+        co_yield tracing.value();
+    }
+    std::queue<BFSIntakeElement> bfsIntakeQueue = startIntakeQueue(grid, mapTemplate, borders);
+    // Zone of each tile, kept up to date by the intake
+    Matrix<Identifiable> zoneLabels(grid.getWidth(), grid.getHeight(), Identifiable::nullID);
+    for (int y = 0; y < grid.getHeight(); ++y){
+        for (int x = 0; x < grid.getWidth(); ++x){
+            zoneLabels.set(x, y, grid.getTileID(x, y));
         }
     }
 
+    long long processed = 0;
     while (!bfsIntakeQueue.empty()){
+        if (++processed % blendYieldInterval == 0)
+            co_yield StageProgress{StagePhase::blendIntake, processed};
         BFSIntakeElement bfsElement = bfsIntakeQueue.front();
         bfsIntakeQueue.pop();
         if (!zoneInfluence.contains(bfsElement.intakingZone) || !zoneInfluence.contains(bfsElement.spreadingZone)){
@@ -102,6 +208,7 @@ inline ZoneMasks blendConnections(const Grid<T>& grid, const EdgeGraph<T, BasicS
         }
         zoneInfluence.at(bfsElement.intakingZone).set(bfsElement.coords.x, bfsElement.coords.y, 0.0);
         zoneInfluence.at(bfsElement.spreadingZone).set(bfsElement.coords.x, bfsElement.coords.y, 1.0);
+        zoneLabels.set(bfsElement.coords.x, bfsElement.coords.y, bfsElement.spreadingZone);
         bfsIntakeQueue.push({
             bfsElement.coords.x+1, bfsElement.coords.y,
             bfsElement.intakingZone,
@@ -127,37 +234,47 @@ inline ZoneMasks blendConnections(const Grid<T>& grid, const EdgeGraph<T, BasicS
             bfsElement.iterationsLeft - 1
         });
     }
+    co_yield StageProgress{StagePhase::blendIntake, processed};
     // Intake end, starting guarantor
 
-    const auto& symEdges = mapTemplate.getSymEdges();
-
-    std::unordered_map<Identifiable, Matrix<double>, IDHash> zoneBonuses;
+    IDMap<Matrix<double>> zoneBonuses;
     for (Identifiable zone : mapTemplate.getIDs()){
         zoneBonuses[zone] = Matrix(grid.getWidth(), grid.getHeight(), 0.0);
-
+        co_yield StageProgress{StagePhase::blendGuarantor, 0};
     }
     std::queue<BFSGuarantorElement> bfsGuarantorQueue;
-    std::unordered_map<std::pair<Identifiable, Identifiable>, int, AsymPairIDHash> areaLeft;
-
-    for (auto& [idPair, asymEdgeParams] : asymEdges){
-        areaLeft[idPair] = asymEdgeParams.areaGuaranteed;
+    // Indexed by the asym edge parameters index of the connection table
+    std::vector<int> areaLeft(connections.getAsymParamsCount());
+    for (int i = 0; i < connections.getAsymParamsCount(); i++){
+        areaLeft[i] = connections.getAsymParams(i).areaGuaranteed;
     }
 
-    for (auto& [id, matrix] : zoneInfluence){
-        for (size_t y = 0; y < grid.getHeight(); ++y){
-            for (size_t x = 0; x < grid.getWidth(); ++x){
-                if (zoneInfluence.at(id).get(x, y) < 1.0){
-                    continue;
-                }
-                tryAddToBFSGuarantorQueue(bfsGuarantorQueue, IntVector2(x+1, y), id, zoneBonuses, zoneInfluence, asymEdges);
-                tryAddToBFSGuarantorQueue(bfsGuarantorQueue, IntVector2(x-1, y), id, zoneBonuses, zoneInfluence, asymEdges);
-                tryAddToBFSGuarantorQueue(bfsGuarantorQueue, IntVector2(x, y+1), id, zoneBonuses, zoneInfluence, asymEdges);
-                tryAddToBFSGuarantorQueue(bfsGuarantorQueue, IntVector2(x, y-1), id, zoneBonuses, zoneInfluence, asymEdges);
+    processed = 0;
+    // One pass finds the seeds of every zone, they are queued zone by zone in ascending ID order
+    IDMap<std::vector<BFSGuarantorElement>> guarantorSeeds;
+    for (int y = 0; y < grid.getHeight(); ++y){
+        for (int x = 0; x < grid.getWidth(); ++x){
+            Identifiable id = zoneLabels.get(x, y);
+            if (id == Identifiable::nullID){
+                continue;
             }
+            std::vector<BFSGuarantorElement>& seeds = guarantorSeeds[id];
+            tryAddToBFSGuarantorQueue(seeds, IntVector2(x+1, y), id, zoneLabels, connections);
+            tryAddToBFSGuarantorQueue(seeds, IntVector2(x-1, y), id, zoneLabels, connections);
+            tryAddToBFSGuarantorQueue(seeds, IntVector2(x, y+1), id, zoneLabels, connections);
+            tryAddToBFSGuarantorQueue(seeds, IntVector2(x, y-1), id, zoneLabels, connections);
+        }
+        co_yield StageProgress{StagePhase::blendGuarantor, processed};
+    }
+    for (auto& [id, seeds] : guarantorSeeds){
+        for (const BFSGuarantorElement& seed : seeds){
+            bfsGuarantorQueue.push(seed);
         }
     }
 
     while (!bfsGuarantorQueue.empty()){
+        if (++processed % blendYieldInterval == 0)
+            co_yield StageProgress{StagePhase::blendGuarantor, processed};
         BFSGuarantorElement bfsElement = bfsGuarantorQueue.front();
         bfsGuarantorQueue.pop();
 
@@ -165,13 +282,13 @@ inline ZoneMasks blendConnections(const Grid<T>& grid, const EdgeGraph<T, BasicS
             !grid.isValidPoint(bfsElement.coords)
             || zoneInfluence.at(bfsElement.zoneApplied).get(bfsElement.coords) <= 0.0
             || zoneBonuses.at(bfsElement.zoneApplied).get(bfsElement.coords) >= bfsElement.weightSpread
-            || areaLeft.at(std::make_pair(bfsElement.zoneApplied, bfsElement.neighbourStarted)) < 1
+            || areaLeft[connections.findAsymParamIndex(bfsElement.zoneApplied, bfsElement.neighbourStarted)] < 1
         ){
             continue;
         }
 
         zoneBonuses.at(bfsElement.zoneApplied).access(bfsElement.coords) += bfsElement.weightSpread;
-        areaLeft.at(std::make_pair(bfsElement.zoneApplied, bfsElement.neighbourStarted))--;
+        areaLeft[connections.findAsymParamIndex(bfsElement.zoneApplied, bfsElement.neighbourStarted)]--;
 
         bfsGuarantorQueue.push(BFSGuarantorElement{
             .coords = {bfsElement.coords.x-1, bfsElement.coords.y},
@@ -200,28 +317,40 @@ inline ZoneMasks blendConnections(const Grid<T>& grid, const EdgeGraph<T, BasicS
     }
 
 
+    co_yield StageProgress{StagePhase::blendGuarantor, processed};
     // Guarantor end, starting blend
     std::queue<BFSBlendElement> bfsBlendQueue;
 
-    for (auto& [id, matrix] : zoneInfluence){    
-        for (size_t y = 0; y < grid.getHeight(); ++y){
-            for (size_t x = 0; x < grid.getWidth(); ++x){
-                if (matrix.get(x, y) <= 0.001){
-                    continue;
-                }
-                tryAddToBFSBlendQueue(bfsBlendQueue, IntVector2(x+1, y), id, zoneInfluence, symEdges);
-                tryAddToBFSBlendQueue(bfsBlendQueue, IntVector2(x-1, y), id, zoneInfluence, symEdges);
-                tryAddToBFSBlendQueue(bfsBlendQueue, IntVector2(x, y+1), id, zoneInfluence, symEdges);
-                tryAddToBFSBlendQueue(bfsBlendQueue, IntVector2(x, y-1), id, zoneInfluence, symEdges);
+    IDMap<std::vector<BFSBlendElement>> blendSeeds;
+    for (int y = 0; y < grid.getHeight(); ++y){
+        for (int x = 0; x < grid.getWidth(); ++x){
+            Identifiable id = zoneLabels.get(x, y);
+            if (id == Identifiable::nullID){
+                continue;
             }
+            std::vector<BFSBlendElement>& seeds = blendSeeds[id];
+            tryAddToBFSBlendQueue(seeds, IntVector2(x+1, y), id, zoneLabels, connections);
+            tryAddToBFSBlendQueue(seeds, IntVector2(x-1, y), id, zoneLabels, connections);
+            tryAddToBFSBlendQueue(seeds, IntVector2(x, y+1), id, zoneLabels, connections);
+            tryAddToBFSBlendQueue(seeds, IntVector2(x, y-1), id, zoneLabels, connections);
+        }
+        co_yield StageProgress{StagePhase::blendSpread, 0};
+    }
+    for (auto& [id, seeds] : blendSeeds){
+        for (const BFSBlendElement& seed : seeds){
+            bfsBlendQueue.push(seed);
         }
     }
 
-    std::unordered_map<Identifiable, Matrix<double>, IDHash> zoneBlendInfluence;
+    IDMap<Matrix<double>> zoneBlendInfluence;
     for (Identifiable id : mapTemplate.getIDs()){
         zoneBlendInfluence[id] = Matrix(grid.getWidth(), grid.getHeight(), 0.0);
+        co_yield StageProgress{StagePhase::blendSpread, 0};
     }
+    processed = 0;
     while (!bfsBlendQueue.empty()){
+        if (++processed % blendYieldInterval == 0)
+            co_yield StageProgress{StagePhase::blendSpread, processed};
         BFSBlendElement bfsElement = bfsBlendQueue.front();
         bfsBlendQueue.pop();
         if (
@@ -267,6 +396,9 @@ inline ZoneMasks blendConnections(const Grid<T>& grid, const EdgeGraph<T, BasicS
         });
     }
 
+    co_yield StageProgress{StagePhase::blendSpread, processed};
+
+    processed = 0;
     Matrix<double> sumInfluenceMatrix = Matrix(grid.getWidth(), grid.getHeight(), 0.0);
     for (auto& [id, matrix] : zoneBlendInfluence){    
         for (size_t y = 0; y < grid.getHeight(); ++y){
@@ -276,6 +408,7 @@ inline ZoneMasks blendConnections(const Grid<T>& grid, const EdgeGraph<T, BasicS
                 }
                 sumInfluenceMatrix.access(x, y) += matrix.get(x, y);
             }
+            co_yield StageProgress{StagePhase::blendNormalize, ++processed};
         }
     }
 
@@ -288,99 +421,166 @@ inline ZoneMasks blendConnections(const Grid<T>& grid, const EdgeGraph<T, BasicS
                 }    
                 matrix.access(x, y) = zoneBlendInfluence.at(id).get(x, y) / sumInfluenceMatrix.get(x, y);
             }
+            co_yield StageProgress{StagePhase::blendNormalize, ++processed};
         }
     }
 
-    return ZoneMasks{
-        .bonusMask = zoneBonuses,
-        .influenceMask = zoneInfluence
+    result = ZoneMasks{
+        .bonusMask = std::move(zoneBonuses),
+        .influenceMask = std::move(zoneInfluence)
     };
+    co_yield StageProgress{StagePhase::blendNormalize, processed};
+}
+
+
+template <typename T>
+inline SparseZoneMasks blendConnectionsSparse(const Grid<T>& grid, const EdgeGraph<T, BasicSymConnection, BasicAsymConnection>& mapTemplate)
+{
+    SparseZoneMasks result;
+    for (Generator<StageProgress> blending = blendConnectionsSparseStaged(grid, mapTemplate, result); blending.next();){}
+    return result;
+}
+
+template <typename T>
+Generator<StageProgress> blendConnectionsSparseStaged(const Grid<T>& grid, const EdgeGraph<T, BasicSymConnection, BasicAsymConnection>& mapTemplate, SparseZoneMasks& result)
+{
+    std::vector<int> labels;
+    labels.reserve(static_cast<size_t>(grid.getWidth()) * grid.getHeight());
+    for (int y = 0; y < grid.getHeight(); ++y){
+        for (int x = 0; x < grid.getWidth(); ++x){
+            labels.push_back(grid.getTileID(x, y).getID());
+        }
+        co_yield StageProgress{StagePhase::blendIntake, 0};
+    }
+    std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<tiles::Border>, PairIDHash> borders;
+    for (Generator<StageProgress> tracing = tiles::Border::traceAllBorders(grid, borders); tracing.next();){
+        co_yield tracing.value();
+    }
+    Generator<StageProgress> blending = blendLabelsSparseStaged(
+        std::move(labels),
+        grid.getWidth(),
+        grid.getHeight(),
+        BasicConnectionTable(mapTemplate),
+        startIntakeQueue(grid, mapTemplate, borders),
+        result
+    );
+    while (blending.next()){
+        co_yield blending.value();
+    }
+}
+
+
+template <typename T>
+std::queue<BFSIntakeElement> startIntakeQueue(
+        const Grid<T>& grid,
+        const EdgeGraph<T, BasicSymConnection, BasicAsymConnection>& mapTemplate,
+        const std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<tiles::Border>, PairIDHash>& borders
+    ){
+    std::queue<BFSIntakeElement> result;
+    const auto& asymEdges = mapTemplate.getAsymEdges();
+    for (auto& [idPair, asymEdgeParams] : asymEdges){
+        auto reversedIdPair = std::make_pair(idPair.second, idPair.first);
+        auto it = borders.find(idPair);
+        auto reversedIt = borders.find(reversedIdPair);
+        if (it == borders.end()){
+            it = reversedIt;
+            if (reversedIt == borders.end()){
+                continue; //No border found between these zones
+            }
+        }
+        for (tiles::Border border : it->second){
+            bool leftOriented = grid.getTileID(border.getLeft(0)) == idPair.first;
+            for (tiles::Border::Segment segment : border.getSegments()){
+                result.push({
+                    leftOriented? segment.getLeftPos() : segment.getRightPos(),
+                    idPair.first,
+                    idPair.second,
+                    asymEdgeParams.intakeDistance
+                });
+            }
+        }
+    }
+    return result;
 }
 
 
 inline void tryAddToBFSGuarantorQueue(
-        std::queue<BFSGuarantorElement>& bfsGuarantorQueue,
+        std::vector<BFSGuarantorElement>& guarantorSeeds,
         IntVector2 coords,
         Identifiable neighbourZone,
-        const std::unordered_map<Identifiable, Matrix<double>, IDHash>& matrices,
-        const std::unordered_map<Identifiable, Matrix<double>, IDHash>& zoneMasks,
-        const std::unordered_map<std::pair<Identifiable, Identifiable>, BasicAsymConnection, AsymPairIDHash>& asymEdges
-    ){
-    if (
-        !matrices.at(neighbourZone).isValidPoint(coords)
-        || zoneMasks.at(neighbourZone).get(coords) >= 0.001
+        const Matrix<Identifiable>& zoneLabels,
+        const BasicConnectionTable& connections
     ){
+    if (!zoneLabels.isValidPoint(coords)){
         return;
     }
-    for (auto& [spreadingZone, matrix] : matrices){
-        if (
-            spreadingZone == neighbourZone
-            || zoneMasks.at(spreadingZone).get(coords) <= 0.001
-        ){
-            continue; // We seek for neighbour DIFFERENT zone
-        }
-        auto it = asymEdges.find({spreadingZone, neighbourZone}); // Main is where guaranteed area is applied. Neighbour is the relative border where it start from.
-        if (it == asymEdges.end()){
-            continue;
-        }
-        bfsGuarantorQueue.push(BFSGuarantorElement{
-            .coords = coords,
-            .zoneApplied = spreadingZone,
-            .neighbourStarted = neighbourZone,
-            .weightSpread = it->second.bonusValue
-        });
+    Identifiable spreadingZone = zoneLabels.get(coords);
+    if (spreadingZone == Identifiable::nullID || spreadingZone == neighbourZone){
+        return; // We seek for neighbour DIFFERENT zone
+    }
+    const BasicAsymConnection* connection = connections.findAsym(spreadingZone, neighbourZone); // Main is where guaranteed area is applied. Neighbour is the relative border where it start from.
+    if (!connection){
+        return;
     }
+    guarantorSeeds.push_back(BFSGuarantorElement{
+        .coords = coords,
+        .zoneApplied = spreadingZone,
+        .neighbourStarted = neighbourZone,
+        .weightSpread = connection->bonusValue
+    });
 }
 
 inline void tryAddToBFSBlendQueue(
-        std::queue<BFSBlendElement>& bfsBlendQueue,
+        std::vector<BFSBlendElement>& blendSeeds,
         IntVector2 coords,
         Identifiable spreadingZone,
-        const std::unordered_map<Identifiable, Matrix<double>, IDHash>& matrices,
-        const std::unordered_map<std::pair<Identifiable, Identifiable>, BasicSymConnection, PairIDHash>& symEdges
-    ){
-    if (
-        !matrices.at(spreadingZone).isValidPoint(coords)
-        || matrices.at(spreadingZone).get(coords) >= 0.001
+        const Matrix<Identifiable>& zoneLabels,
+        const BasicConnectionTable& connections
     ){
+    if (!zoneLabels.isValidPoint(coords)){
         return;
     }
-    for (auto& [zoneID, matrix] : matrices){
-        if (
-            zoneID == spreadingZone
-            || matrix.get(coords) <= 0.001
-        ){
-            continue;
-        }
-        auto it = symEdges.find({zoneID, spreadingZone});
-        if (it == symEdges.end()){
-            it = symEdges.find({spreadingZone, zoneID});
-        }
-        if (it == symEdges.end()){
-            continue;
-        }
-        bfsBlendQueue.push({
-            coords,
-            zoneID,
-            it->second.blendDistance,
-            it->second.blendDistance
-        });
+    Identifiable zoneID = zoneLabels.get(coords);
+    if (zoneID == Identifiable::nullID || zoneID == spreadingZone){
+        return;
+    }
+    const BasicSymConnection* connection = connections.findSym(zoneID, spreadingZone);
+    if (!connection){
+        return;
     }
+    blendSeeds.push_back({
+        coords,
+        zoneID,
+        connection->blendDistance,
+        connection->blendDistance
+    });
 }
 
 
 template <typename T>
-inline std::unordered_map<Identifiable, Matrix<double>, IDHash> buildZoneMasks(const Grid<T>& grid)
+inline IDMap<Matrix<double>> buildZoneMasks(const Grid<T>& grid)
 {
-    std::unordered_map<Identifiable, Matrix<double>, IDHash> result;
+    IDMap<Matrix<double>> result;
+    for (Generator<StageProgress> building = buildZoneMasksStaged(grid, result); building.next();){}
+    return result;
+}
+
+template <typename T>
+inline Generator<StageProgress> buildZoneMasksStaged(const Grid<T>& grid, IDMap<Matrix<double>>& result)
+{
+    result.clear();
     for (Identifiable id : grid.getTileIDs()){
-        result[id] = Matrix<double>(grid.getWidth(), grid.getHeight(), 0.0);       
+        result[id] = Matrix<double>(grid.getWidth(), grid.getHeight(), 0.0);
+        co_yield StageProgress{StagePhase::blendIntake, 0};
     }
-    for (auto it = grid.begin(); it != grid.end(); ++it){
-        if (*it == Identifiable::nullID){
-            continue;
+    for (int y = 0; y < grid.getHeight(); ++y){
+        for (int x = 0; x < grid.getWidth(); ++x){
+            Identifiable id = grid.getTileID(x, y);
+            if (id == Identifiable::nullID){
+                continue;
+            }
+            result[id].set(x, y, 1.0);
         }
-        result[*it].set(it.getX(), it.getY(), 1.0);
+        co_yield StageProgress{StagePhase::blendIntake, 0};
     }
-    return result;
 }
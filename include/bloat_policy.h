@@ -0,0 +1,254 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <type_traits>
+
+#include "2d.h"
+#include "identifiable.h"
+#include "grid.h"
+#include "random_generator.h"
+#include "frontier_filter.h"
+#include "step_recorder.h"
+
+struct ZoneTile : IntVector2{
+    ZoneTile(IntVector2 point, Identifiable id) : IntVector2{point.x, point.y}, zoneID(id){};
+    ZoneTile(int x, int y, Identifiable id) : IntVector2{x, y}, zoneID(id){};
+    Identifiable zoneID;
+};
+
+// Compile-time counterparts of bloatStrategies. A policy bloats one tile through any Pusher providing
+// push, setZoneTile, isEmpty, isValidPoint, tryGetID and getBloatStep, so with a concrete Pusher everything inlines.
+// The virtual strategies delegate to these, so both paths produce the same result.
+namespace bloatPolicies{
+
+    // Tag for ZoneBloater to use the runtime BloatStrategy set by setBloatMode.
+    struct Dynamic{};
+
+    template <typename Policy>
+    concept isStatic = !std::same_as<Policy, Dynamic>;
+
+    // A parallel safe policy only checks and sets the active tile and pushes regardless of other tiles,
+    // so within a step the outcome of a tile depends only on which of the entries setting it comes first.
+    template <typename Policy>
+    concept isParallelSafe = isStatic<Policy> && Policy::parallelSafe;
+
+    // Whether bloating the entry sets its tile, given that the tile is empty. Policies which may
+    // leave an empty tile unset provide their own setsTile, which must not depend on other tiles.
+    template <typename Policy>
+    bool setsTile(const Policy& policy, const ZoneTile& zoneTile, long long step){
+        if constexpr (requires{policy.setsTile(zoneTile, step);}){
+            return policy.setsTile(zoneTile, step);
+        } else{
+            return true;
+        }
+    }
+
+    // enqueueOnce lets a FrontierFilter drop every push of a tile after the first one.
+
+    // Writes straight to a grid and appends to a frontier vector.
+    template <typename T>
+    struct GridPusher{
+        Grid<T>& grid;
+        std::vector<ZoneTile>& frontier;
+        FrontierFilter& filter;
+        long long step;
+        StepRecorder* recorder = nullptr;
+
+        void push(const ZoneTile& zoneTile){
+            if (filter.accept(zoneTile, grid.isEmpty(zoneTile)))
+                frontier.push_back(zoneTile);
+        }
+        void setZoneTile(const ZoneTile& zoneTile){
+            grid.setTile(zoneTile.x, zoneTile.y, zoneTile.zoneID);
+            if (recorder)
+                recorder->record(zoneTile.y * grid.getWidth() + zoneTile.x, zoneTile.zoneID.getID());
+        }
+        bool isEmpty(IntVector2 point) const{return grid.isEmpty(point);}
+        bool isValidPoint(IntVector2 point) const{return grid.isValidPoint(point);}
+        std::optional<Identifiable> tryGetID(IntVector2 point) const{return grid.tryGetID(point);}
+        long long getBloatStep() const{return step;}
+    };
+
+    template <typename Pusher>
+    void pushIfValid(Pusher& pusher, IntVector2 point, Identifiable zoneID){
+        if (pusher.isValidPoint(point))
+            pusher.push(ZoneTile(point, zoneID));
+    }
+
+    template <typename Pusher>
+    void pushStraightNeighbours(Pusher& pusher, const ZoneTile& activeTile){
+        int x = activeTile.x;
+        int y = activeTile.y;
+        pushIfValid(pusher, {x - 1, y}, activeTile.zoneID);
+        pushIfValid(pusher, {x + 1, y}, activeTile.zoneID);
+        pushIfValid(pusher, {x, y - 1}, activeTile.zoneID);
+        pushIfValid(pusher, {x, y + 1}, activeTile.zoneID);
+    }
+
+    struct Straight{
+        static constexpr bool parallelSafe = true;
+        static constexpr bool enqueueOnce = true;
+
+        template <typename Pusher>
+        void bloat(const ZoneTile& activeTile, Pusher& pusher) const{
+            if (!pusher.isEmpty(activeTile)){
+                return;
+            }
+            pusher.setZoneTile(activeTile);
+            pushStraightNeighbours(pusher, activeTile);
+        }
+    };
+
+    struct Chebyshev{
+        static constexpr bool parallelSafe = true;
+        static constexpr bool enqueueOnce = true;
+
+        template <typename Pusher>
+        void bloat(const ZoneTile& activeTile, Pusher& pusher) const{
+            if (!pusher.isEmpty(activeTile)){
+                return;
+            }
+            int x = activeTile.x;
+            int y = activeTile.y;
+            pusher.setZoneTile(activeTile);
+            pushStraightNeighbours(pusher, activeTile);
+            pushIfValid(pusher, {x - 1, y - 1}, activeTile.zoneID);
+            pushIfValid(pusher, {x + 1, y - 1}, activeTile.zoneID);
+            pushIfValid(pusher, {x + 1, y + 1}, activeTile.zoneID);
+            pushIfValid(pusher, {x - 1, y + 1}, activeTile.zoneID);
+        }
+    };
+
+    struct DiagonalRandom{
+        static constexpr bool parallelSafe = false;
+        static constexpr bool enqueueOnce = true;
+        double diagonalChance = 0.4;
+
+        template <typename Pusher>
+        void bloat(const ZoneTile& activeTile, Pusher& pusher) const{
+            if (!pusher.isEmpty(activeTile)){
+                return;
+            }
+            int x = activeTile.x;
+            int y = activeTile.y;
+            pusher.setZoneTile(activeTile);
+            pushStraightNeighbours(pusher, activeTile);
+            for (IntVector2 point : {IntVector2{x - 1, y - 1}, IntVector2{x - 1, y + 1}, IntVector2{x + 1, y + 1}, IntVector2{x + 1, y - 1}}){
+                if (pusher.isValidPoint(point) && RandomGenerator::instance().chanceOccurred(diagonalChance))
+                    pusher.push(ZoneTile(point, activeTile.zoneID));
+            }
+        }
+    };
+
+    // Draws for the hashed policies, stream tells apart several draws for the same entry.
+    inline bool hashedChance(double chance, uint64_t seed, const ZoneTile& zoneTile, long long step, int stream){
+        return RandomGenerator::counterChanceOccurred(chance, RandomGenerator::counterHash(seed, zoneTile.x, zoneTile.y, zoneTile.zoneID.getID(), step, stream));
+    }
+
+    // DiagonalRandom with every draw hashed from (seed, tile, zone, step, direction) instead of taken
+    // from RandomGenerator::instance(), so the map doesn't depend on the bloat order or the thread count.
+    struct HashedDiagonalRandom{
+        static constexpr bool parallelSafe = true;
+        static constexpr bool enqueueOnce = true;
+        double diagonalChance = 0.4;
+        uint64_t seed = 0;
+
+        template <typename Pusher>
+        void bloat(const ZoneTile& activeTile, Pusher& pusher) const{
+            if (!pusher.isEmpty(activeTile)){
+                return;
+            }
+            int x = activeTile.x;
+            int y = activeTile.y;
+            pusher.setZoneTile(activeTile);
+            pushStraightNeighbours(pusher, activeTile);
+            int stream = 1;
+            for (IntVector2 point : {IntVector2{x - 1, y - 1}, IntVector2{x - 1, y + 1}, IntVector2{x + 1, y + 1}, IntVector2{x + 1, y - 1}}){
+                if (pusher.isValidPoint(point) && hashedChance(diagonalChance, seed, activeTile, pusher.getBloatStep(), stream))
+                    pusher.push(ZoneTile(point, activeTile.zoneID));
+                stream++;
+            }
+        }
+    };
+
+    // A tile that fails the chance is pushed back to retry on the next step.
+    struct Random{
+        static constexpr bool parallelSafe = false;
+        static constexpr bool enqueueOnce = false; // retries push the same tile again
+        double randomChance = 0.5;
+
+        template <typename Pusher>
+        void bloat(const ZoneTile& activeTile, Pusher& pusher) const{
+            if (!pusher.isEmpty(activeTile)){
+                return;
+            }
+            if (!RandomGenerator::instance().chanceOccurred(randomChance)){
+                pusher.push(activeTile);
+                return;
+            }
+            pusher.setZoneTile(activeTile);
+            pushStraightNeighbours(pusher, activeTile);
+        }
+    };
+
+    // Random with the draw hashed from (seed, tile, zone, step), see HashedDiagonalRandom.
+    struct HashedRandom{
+        static constexpr bool parallelSafe = true;
+        static constexpr bool enqueueOnce = false; // retries push the same tile again
+        double randomChance = 0.5;
+        uint64_t seed = 0;
+
+        bool setsTile(const ZoneTile& zoneTile, long long step) const{
+            return hashedChance(randomChance, seed, zoneTile, step, 0);
+        }
+
+        template <typename Pusher>
+        void bloat(const ZoneTile& activeTile, Pusher& pusher) const{
+            if (!pusher.isEmpty(activeTile)){
+                return;
+            }
+            if (!setsTile(activeTile, pusher.getBloatStep())){
+                pusher.push(activeTile);
+                return;
+            }
+            pusher.setZoneTile(activeTile);
+            pushStraightNeighbours(pusher, activeTile);
+        }
+    };
+
+    // Fills an empty tile when two orthogonal neighbours forming a corner share a zone.
+    struct AdjacentCornerFill{
+        static constexpr bool parallelSafe = false;
+        static constexpr bool enqueueOnce = false; // a tile is checked again when its neighbours change
+
+        template <typename Pusher>
+        void bloat(const ZoneTile& activeTile, Pusher& pusher) const{
+            int x = activeTile.x;
+            int y = activeTile.y;
+            if (!pusher.isEmpty({x, y})){
+                return;
+            }
+
+            Identifiable left = pusher.tryGetID({x-1, y}).value_or(Identifiable::nullID);
+            Identifiable upper = pusher.tryGetID({x, y-1}).value_or(Identifiable::nullID);
+            Identifiable right = pusher.tryGetID({x+1, y}).value_or(Identifiable::nullID);
+            Identifiable bottom = pusher.tryGetID({x, y+1}).value_or(Identifiable::nullID);
+
+            bool upperLeft = upper != Identifiable::nullID && upper == left;
+            bool upperRight = upper != Identifiable::nullID && upper == right;
+            bool bottomRight = bottom != Identifiable::nullID && bottom == right;
+            bool bottomLeft = bottom != Identifiable::nullID && bottom == left;
+
+            if (!(upperLeft || upperRight || bottomRight || bottomLeft))
+                return;
+
+            if (upperLeft || bottomLeft)
+                pusher.setZoneTile({x, y, left});
+            if (upperRight || bottomRight)
+                pusher.setZoneTile({x, y, right});
+
+            pushStraightNeighbours(pusher, activeTile);
+        }
+    };
+}
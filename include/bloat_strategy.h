@@ -16,12 +16,7 @@
 #include "random_generator.h"
 
 #include "self_pointer.h"
-
-struct ZoneTile : IntVector2{
-    ZoneTile(IntVector2 point, Identifiable id) : IntVector2{point.x, point.y}, zoneID(id){};
-    ZoneTile(int x, int y, Identifiable id) : IntVector2{x, y}, zoneID(id){};
-    Identifiable zoneID;
-};
+#include "bloat_policy.h"
 
 class ZoneTilePusher : public SelfPointerOwner<ZoneTilePusher>{
 public:
@@ -31,6 +26,8 @@ public:
     virtual bool isEmpty(IntVector2 point) const = 0;
     virtual std::optional<Identifiable> tryGetID(IntVector2 point) const = 0;
     virtual bool isValidPoint(IntVector2 point) const = 0;
+    // Index of the layer being bloated, counted from 0 since init.
+    virtual long long getBloatStep() const = 0;
 };
 
 class BloatStrategy{
@@ -47,9 +44,14 @@ public:
     BloatStrategy& operator=(BloatStrategy&&) = default;
 
     virtual void bloat(const ZoneTile& activeTile) = 0;
+    // Same as bloatPolicies enqueueOnce, false unless the strategy is known to allow it.
+    virtual bool isEnqueueOnce() const{return false;};
 
     void setZoneTilePusher(SelfPointer<ZoneTilePusher> zoneTilePusher){this->zoneTilePusher = zoneTilePusher;};
 protected:
+    // Throws std::logic_error if the pusher is gone.
+    ZoneTilePusher& lockPusher() const;
+
     SelfPointer<ZoneTilePusher> zoneTilePusher;
 };
 
@@ -64,6 +66,7 @@ namespace bloatStrategies{
         
     
         void bloat(const ZoneTile &activeTile) override;
+        bool isEnqueueOnce() const override{return bloatPolicies::Straight::enqueueOnce;};
     };
 
     class ChebyshevBloat : public BloatStrategy{
@@ -72,6 +75,7 @@ namespace bloatStrategies{
         ChebyshevBloat() : BloatStrategy(){};
 
         void bloat(const ZoneTile &activeTile) override;
+        bool isEnqueueOnce() const override{return bloatPolicies::Chebyshev::enqueueOnce;};
     };
 
     class DiagonalRandomBloat : public BloatStrategy{
@@ -93,6 +97,14 @@ namespace bloatStrategies{
             diagonalChance{diagonalChance}{};
 
         void bloat(const ZoneTile& activeTile) override;
+        bool isEnqueueOnce() const override{return bloatPolicies::DiagonalRandom::enqueueOnce;};
+
+        // Draws are hashed from the seed, tile, zone and layer (bloatPolicies::HashedDiagonalRandom),
+        // so the result doesn't depend on the frontier order.
+        void setCounterSeed(uint64_t seed){counterSeed = seed;};
+        std::optional<uint64_t> getCounterSeed() const{return counterSeed;};
+    private:
+        std::optional<uint64_t> counterSeed;
     };
 
     class RandomBloat : public BloatStrategy{
@@ -105,20 +117,26 @@ namespace bloatStrategies{
         RandomBloat(RandomBloat&&) = default;
         RandomBloat& operator=(RandomBloat&&) = default;
 
-        RandomBloat(double diagonalChance) :
+        RandomBloat(double randomChance) :
             BloatStrategy(),
             randomChance{randomChance}{};
         RandomBloat() :
             BloatStrategy(),
             randomChance{0.5}{};
-        RandomBloat(SelfPointer<ZoneTilePusher> ZoneTilePusher) :
+        RandomBloat(SelfPointer<ZoneTilePusher> zoneTilePusher) :
             BloatStrategy(zoneTilePusher),
             randomChance{0.5}{};
-        RandomBloat(SelfPointer<ZoneTilePusher> zoneTilePusher, double diagonalChance) :
+        RandomBloat(SelfPointer<ZoneTilePusher> zoneTilePusher, double randomChance) :
             BloatStrategy(zoneTilePusher),
             randomChance{randomChance}{};
 
         void bloat(const ZoneTile& activeTile) override;
+
+        // See DiagonalRandomBloat::setCounterSeed, uses bloatPolicies::HashedRandom.
+        void setCounterSeed(uint64_t seed){counterSeed = seed;};
+        std::optional<uint64_t> getCounterSeed() const{return counterSeed;};
+    private:
+        std::optional<uint64_t> counterSeed;
     };
 
     class AdjacentCornerFill : public BloatStrategy{
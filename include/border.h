@@ -10,6 +10,8 @@
 
 #include "2d.h"
 #include "grid.h"
+#include "generator.h"
+#include "stage_progress.h"
 
 namespace tiles{
 
@@ -86,6 +88,9 @@ namespace tiles{
 
         template <typename T>
         static std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<Border>, PairIDHash> getAllBorders(const Grid<T>& matrix);
+        // Traces the same borders as getAllBorders into result, yielding after each row of the edge scan and after each border.
+        template <typename T>
+        static Generator<StageProgress> traceAllBorders(const Grid<T>& grid, std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<Border>, PairIDHash>& result);
 
         void initPassData(PassParams params);
         
@@ -132,6 +137,12 @@ namespace tiles{
     template <typename T>
     std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<Border>, PairIDHash> Border::getAllBorders(const Grid<T>& grid){
         std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<Border>, PairIDHash> result;
+        for (Generator<StageProgress> tracing = traceAllBorders(grid, result); tracing.next();){}
+        return result;
+    }
+
+    template <typename T>
+    Generator<StageProgress> Border::traceAllBorders(const Grid<T>& grid, std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<Border>, PairIDHash>& result){
         std::unordered_set<Border::Edge, Border::Edge::Hash> freeBorderSegments;
         
 
@@ -141,6 +152,7 @@ namespace tiles{
                     freeBorderSegments.insert(Border::Edge({static_cast<int>(c), static_cast<int>(r)}, Orientation::vertical));
                 }
             }
+            co_yield StageProgress{StagePhase::borders, 0};
         }
         for (size_t r = 0; r < grid.getHeight(); r++){
             for (size_t c = 0; c < grid.getWidth() - 1; c++){
@@ -148,12 +160,14 @@ namespace tiles{
                     freeBorderSegments.insert(Border::Edge({static_cast<int>(c), static_cast<int>(r)},  Orientation::horizontal));
                 }
             }
+            co_yield StageProgress{StagePhase::borders, 0};
         }
+        long long traced = 0;
         while (freeBorderSegments.size()){
             auto borderPair = getNeighbours(*(freeBorderSegments.begin()), grid);
             result[borderPair].push_back(Border(freeBorderSegments, freeBorderSegments.begin(), grid));
+            co_yield StageProgress{StagePhase::borders, ++traced};
         }
-        return result;
     }
 
     template <typename T>
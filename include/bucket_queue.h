@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+// Monotone priority queue for integer keys (Dial's algorithm). A key may not be lower than the key of the last
+// popped bucket, so the buckets are kept in a ring which grows to fit the largest key - current key span.
+// Push and pop are O(1) amortized, values with equal keys come out in push order.
+template <typename V>
+class BucketQueue{
+    public:
+        explicit BucketQueue(size_t keySpan = 1);
+
+        void push(long long key, const V& value);
+        template <typename... Args>
+        void emplace(long long key, Args&&... args);
+
+        // Moves the values of the lowest non-empty bucket to out, replacing its content, and returns their key.
+        long long popBucket(std::vector<V>& out);
+
+        bool empty() const{return count == 0;};
+        size_t size() const{return count;};
+        // Key of the last popped bucket, lower keys can't be pushed.
+        long long getCurrentKey() const{return currentKey;};
+        void clear();
+
+    private:
+        std::vector<V>& bucketFor(long long key);
+        void grow(size_t keySpan);
+
+        std::vector<std::vector<V>> buckets;
+        long long currentKey = 0;
+        size_t count = 0;
+};
+
+template <typename V>
+BucketQueue<V>::BucketQueue(size_t keySpan){
+    size_t size = 1;
+    while (size < keySpan){
+        size *= 2;
+    }
+    buckets.resize(size);
+}
+
+template <typename V>
+void BucketQueue<V>::push(long long key, const V& value){
+    bucketFor(key).push_back(value);
+    count++;
+}
+
+template <typename V>
+template <typename... Args>
+void BucketQueue<V>::emplace(long long key, Args&&... args){
+    bucketFor(key).emplace_back(std::forward<Args>(args)...);
+    count++;
+}
+
+template <typename V>
+long long BucketQueue<V>::popBucket(std::vector<V>& out){
+    if (empty()){
+        throw std::logic_error("BucketQueue::popBucket: queue is empty");
+    }
+    size_t mask = buckets.size() - 1;
+    while (buckets[currentKey & mask].empty()){
+        currentKey++;
+    }
+    out.clear();
+    out.swap(buckets[currentKey & mask]);
+    count -= out.size();
+    return currentKey;
+}
+
+template <typename V>
+void BucketQueue<V>::clear(){
+    for (std::vector<V>& bucket : buckets){
+        bucket.clear();
+    }
+    currentKey = 0;
+    count = 0;
+}
+
+template <typename V>
+std::vector<V>& BucketQueue<V>::bucketFor(long long key){
+    if (key < currentKey){
+        throw std::invalid_argument("BucketQueue::push: key is lower than the current key");
+    }
+    if (static_cast<unsigned long long>(key - currentKey) >= buckets.size()){
+        grow(key - currentKey + 1);
+    }
+    return buckets[key & (buckets.size() - 1)];
+}
+
+// Keys in the ring are within [currentKey, currentKey + size), so every bucket moves to its new slot by its key.
+template <typename V>
+void BucketQueue<V>::grow(size_t keySpan){
+    size_t size = buckets.size();
+    while (size < keySpan){
+        size *= 2;
+    }
+    std::vector<std::vector<V>> grown(size);
+    size_t oldMask = buckets.size() - 1;
+    for (size_t offset = 0; offset < buckets.size(); offset++){
+        long long key = currentKey + offset;
+        grown[key & (size - 1)] = std::move(buckets[key & oldMask]);
+    }
+    buckets = std::move(grown);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+
+#include "2d.h"
+#include "identifiable.h"
+#include "grid.h"
+#include "matrix.h"
+#include "thread_pool.h"
+
+namespace components{
+
+    enum class Connectivity{
+        four,
+        eight
+    };
+
+    struct Component{
+        Identifiable zoneID; // 0 for Matrix<bool> masks
+        int area = 0;
+        IntVector2 min;
+        IntVector2 max;
+    };
+
+    class Labeling{
+    public:
+        static constexpr int background = -1;
+
+        Labeling() = default;
+        Labeling(int width, int height, std::vector<int> labels, std::vector<Component> components);
+
+        int getWidth() const{return width;};
+        int getHeight() const{return height;};
+        int getLabel(int x, int y) const;
+        int getLabel(IntVector2 point) const;
+        const std::vector<int>& getLabels() const{return labels;};
+
+        // Components are numbered in raster order of their first (top-left most) cell.
+        const std::vector<Component>& getComponents() const{return components;};
+        const Component& getComponent(int label) const;
+        size_t size() const{return components.size();};
+        size_t countComponents(Identifiable zoneID) const;
+
+    private:
+        int width = 0;
+        int height = 0;
+        std::vector<int> labels;
+        std::vector<Component> components;
+    };
+
+    // Two-pass union-find labeling. Cells with equal values form components, Identifiable::nullID cells are background.
+    Labeling label(const std::vector<int>& values, int width, int height, Connectivity connectivity = Connectivity::four);
+
+    // Same result as label(), first pass runs on row strips in parallel which are then merged along strip borders.
+    Labeling labelParallel(const std::vector<int>& values, int width, int height, Connectivity connectivity = Connectivity::four, ThreadPool& pool = ThreadPool::instance());
+
+    Labeling label(const Matrix<bool>& mask, Connectivity connectivity = Connectivity::four);
+    Labeling labelParallel(const Matrix<bool>& mask, Connectivity connectivity = Connectivity::four, ThreadPool& pool = ThreadPool::instance());
+
+    template <typename T>
+    Labeling label(const Grid<T>& grid, Connectivity connectivity = Connectivity::four);
+
+    template <typename T>
+    Labeling labelParallel(const Grid<T>& grid, Connectivity connectivity = Connectivity::four, ThreadPool& pool = ThreadPool::instance());
+
+    template <typename T>
+    std::vector<int> toValues(const Grid<T>& grid);
+
+    std::vector<int> toValues(const Matrix<bool>& mask);
+
+
+    template <typename T>
+    Labeling label(const Grid<T>& grid, Connectivity connectivity){
+        return label(toValues(grid), grid.getWidth(), grid.getHeight(), connectivity);
+    }
+
+    template <typename T>
+    Labeling labelParallel(const Grid<T>& grid, Connectivity connectivity, ThreadPool& pool){
+        return labelParallel(toValues(grid), grid.getWidth(), grid.getHeight(), connectivity, pool);
+    }
+
+    template <typename T>
+    std::vector<int> toValues(const Grid<T>& grid){
+        std::vector<int> values;
+        values.reserve(static_cast<size_t>(grid.getWidth()) * grid.getHeight());
+        for (int y = 0; y < grid.getHeight(); y++){
+            for (int x = 0; x < grid.getWidth(); x++){
+                values.push_back(grid.getTileID(x, y).getID());
+            }
+        }
+        return values;
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <vector>
+
+#include "identifiable.h"
+#include "id_map.h"
+#include "edge_graph.h"
+
+// Compiled Z x Z view of an EdgeGraph's edges. Zones get dense indices, each table cell holds
+// the index of the edge parameters or absent, so a lookup is one array read.
+// The view is a snapshot, it doesn't follow later changes of the graph.
+template <typename SymEdgeT, typename AsymEdgeT>
+class ConnectionTable{
+    public:
+        static constexpr int absent = -1;
+
+        ConnectionTable() = default;
+        template <hasID NodeT>
+        ConnectionTable(const EdgeGraph<NodeT, SymEdgeT, AsymEdgeT>& graph);
+
+        int size() const{return ids.size();};
+        // absent for IDs the graph doesn't know
+        int getIndex(Identifiable id) const;
+        Identifiable getID(int index) const{return ids.at(index);};
+        const std::vector<Identifiable>& getIDs() const{return ids;};
+
+        // Sym edges are found in both directions.
+        int getSymParamIndex(int first, int second) const{return symTable[first * size() + second];};
+        int getAsymParamIndex(int main, int neighbour) const{return asymTable[main * size() + neighbour];};
+        const SymEdgeT& getSymParams(int paramIndex) const{return symParams[paramIndex];};
+        const AsymEdgeT& getAsymParams(int paramIndex) const{return asymParams[paramIndex];};
+        int getSymParamsCount() const{return symParams.size();};
+        int getAsymParamsCount() const{return asymParams.size();};
+
+        // absent when there is no such edge
+        int findSymParamIndex(Identifiable first, Identifiable second) const;
+        int findAsymParamIndex(Identifiable main, Identifiable neighbour) const;
+        // nullptr when there is no such edge
+        const SymEdgeT* findSym(Identifiable first, Identifiable second) const;
+        const AsymEdgeT* findAsym(Identifiable main, Identifiable neighbour) const;
+
+    private:
+        int getOrAddIndex(Identifiable id);
+
+        IDMap<int> indices;
+        std::vector<Identifiable> ids;
+        std::vector<int> symTable;
+        std::vector<int> asymTable;
+        std::vector<SymEdgeT> symParams;
+        std::vector<AsymEdgeT> asymParams;
+};
+
+template <typename SymEdgeT, typename AsymEdgeT>
+template <hasID NodeT>
+ConnectionTable<SymEdgeT, AsymEdgeT>::ConnectionTable(const EdgeGraph<NodeT, SymEdgeT, AsymEdgeT>& graph){
+    for (Identifiable id : graph.getIDs()){
+        getOrAddIndex(id);
+    }
+    for (const auto& [nodePair, edge] : graph.getSymEdges()){
+        getOrAddIndex(nodePair.first);
+        getOrAddIndex(nodePair.second);
+    }
+    for (const auto& [nodePair, edge] : graph.getAsymEdges()){
+        getOrAddIndex(nodePair.first);
+        getOrAddIndex(nodePair.second);
+    }
+    symTable.assign(size() * size(), absent);
+    asymTable.assign(size() * size(), absent);
+
+    // An edge stored under the exact (first, second) key wins over one stored reversed
+    symParams.reserve(graph.getSymEdges().size());
+    for (const auto& [nodePair, edge] : graph.getSymEdges()){
+        int reversed = getIndex(nodePair.second) * size() + getIndex(nodePair.first);
+        if (symTable[reversed] == absent){
+            symTable[reversed] = symParams.size();
+        }
+        symParams.push_back(edge);
+    }
+    int paramIndex = 0;
+    for (const auto& [nodePair, edge] : graph.getSymEdges()){
+        symTable[getIndex(nodePair.first) * size() + getIndex(nodePair.second)] = paramIndex++;
+    }
+
+    asymParams.reserve(graph.getAsymEdges().size());
+    for (const auto& [nodePair, edge] : graph.getAsymEdges()){
+        asymTable[getIndex(nodePair.first) * size() + getIndex(nodePair.second)] = asymParams.size();
+        asymParams.push_back(edge);
+    }
+}
+
+template <typename SymEdgeT, typename AsymEdgeT>
+int ConnectionTable<SymEdgeT, AsymEdgeT>::getIndex(Identifiable id) const{
+    auto it = indices.find(id);
+    return it == indices.end() ? absent : it->second;
+}
+
+template <typename SymEdgeT, typename AsymEdgeT>
+int ConnectionTable<SymEdgeT, AsymEdgeT>::findSymParamIndex(Identifiable first, Identifiable second) const{
+    int firstIndex = getIndex(first);
+    int secondIndex = getIndex(second);
+    if (firstIndex == absent || secondIndex == absent){
+        return absent;
+    }
+    return getSymParamIndex(firstIndex, secondIndex);
+}
+
+template <typename SymEdgeT, typename AsymEdgeT>
+int ConnectionTable<SymEdgeT, AsymEdgeT>::findAsymParamIndex(Identifiable main, Identifiable neighbour) const{
+    int mainIndex = getIndex(main);
+    int neighbourIndex = getIndex(neighbour);
+    if (mainIndex == absent || neighbourIndex == absent){
+        return absent;
+    }
+    return getAsymParamIndex(mainIndex, neighbourIndex);
+}
+
+template <typename SymEdgeT, typename AsymEdgeT>
+const SymEdgeT* ConnectionTable<SymEdgeT, AsymEdgeT>::findSym(Identifiable first, Identifiable second) const{
+    int paramIndex = findSymParamIndex(first, second);
+    return paramIndex == absent ? nullptr : &symParams[paramIndex];
+}
+
+template <typename SymEdgeT, typename AsymEdgeT>
+const AsymEdgeT* ConnectionTable<SymEdgeT, AsymEdgeT>::findAsym(Identifiable main, Identifiable neighbour) const{
+    int paramIndex = findAsymParamIndex(main, neighbour);
+    return paramIndex == absent ? nullptr : &asymParams[paramIndex];
+}
+
+template <typename SymEdgeT, typename AsymEdgeT>
+int ConnectionTable<SymEdgeT, AsymEdgeT>::getOrAddIndex(Identifiable id){
+    auto [it, inserted] = indices.try_emplace(id, static_cast<int>(ids.size()));
+    if (inserted){
+        ids.push_back(id);
+    }
+    return it->second;
+}
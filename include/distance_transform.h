@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+
+#include "2d.h"
+#include "identifiable.h"
+#include "grid.h"
+#include "components.h"
+#include "thread_pool.h"
+
+namespace distanceTransform{
+
+    class NearestSeeds{
+    public:
+        static constexpr int noSeed = -1;
+
+        NearestSeeds() = default;
+        NearestSeeds(int width, int height, std::vector<int> nearest, std::vector<long long> squaredDistances);
+
+        int getWidth() const{return width;};
+        int getHeight() const{return height;};
+        // Cell index (y * width + x) of the nearest seed, noSeed when there are no seeds at all.
+        int getNearest(int x, int y) const;
+        IntVector2 getNearestPoint(int x, int y) const;
+        long long getSquaredDistance(int x, int y) const;
+        double getDistance(int x, int y) const;
+        const std::vector<int>& getNearest() const{return nearest;};
+        const std::vector<long long>& getSquaredDistances() const{return squaredDistances;};
+
+    private:
+        int width = 0;
+        int height = 0;
+        std::vector<int> nearest;
+        std::vector<long long> squaredDistances;
+    };
+
+    // Exact Euclidean feature transform, cells with a value other than Identifiable::nullID are seeds.
+    // A column pass finds the nearest seed in each column, then a row pass takes the lower envelope of
+    // the column parabolas (Felzenszwalb-Huttenlocher), so it is O(width * height) for any number of seeds.
+    // Ties between equally distant seeds go to the left one, then to the upper one.
+    NearestSeeds compute(const std::vector<int>& values, int width, int height);
+
+    // Same result as compute(), columns and then rows are split over the pool.
+    NearestSeeds computeParallel(const std::vector<int>& values, int width, int height, ThreadPool& pool = ThreadPool::instance());
+
+    template <typename T>
+    NearestSeeds compute(const Grid<T>& grid);
+
+    template <typename T>
+    NearestSeeds computeParallel(const Grid<T>& grid, ThreadPool& pool = ThreadPool::instance());
+
+    // Exact Euclidean Voronoi partition in one call, every empty tile gets the zone of its nearest seed tile.
+    template <typename T>
+    void partitionVoronoi(Grid<T>& grid);
+
+    template <typename T>
+    void partitionVoronoiParallel(Grid<T>& grid, ThreadPool& pool = ThreadPool::instance());
+
+    template <typename T>
+    void applyPartition(Grid<T>& grid, const NearestSeeds& nearestSeeds);
+
+
+    template <typename T>
+    NearestSeeds compute(const Grid<T>& grid){
+        return compute(components::toValues(grid), grid.getWidth(), grid.getHeight());
+    }
+
+    template <typename T>
+    NearestSeeds computeParallel(const Grid<T>& grid, ThreadPool& pool){
+        return computeParallel(components::toValues(grid), grid.getWidth(), grid.getHeight(), pool);
+    }
+
+    template <typename T>
+    void partitionVoronoi(Grid<T>& grid){
+        applyPartition(grid, compute(grid));
+    }
+
+    template <typename T>
+    void partitionVoronoiParallel(Grid<T>& grid, ThreadPool& pool){
+        applyPartition(grid, computeParallel(grid, pool));
+    }
+
+    template <typename T>
+    void applyPartition(Grid<T>& grid, const NearestSeeds& nearestSeeds){
+        const std::vector<int>& nearest = nearestSeeds.getNearest();
+        int width = grid.getWidth();
+        for (int y = 0; y < grid.getHeight(); y++){
+            for (int x = 0; x < width; x++){
+                int seed = nearest[y * width + x];
+                if (seed != NearestSeeds::noSeed && grid.isEmpty(x, y)){
+                    grid.setTile(x, y, grid.getTileID(seed % width, seed / width));
+                }
+            }
+        }
+    }
+}
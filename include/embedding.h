@@ -7,9 +7,11 @@
 #include <list>
 #include <algorithm>
 #include <memory>
-#include <unordered_map>
+#include "id_map.h"
 #include <stack>
 #include <cassert>
+#include <chrono>
+#include <optional>
 
 #include "math_util.h"
 #include "graph.h" 
@@ -17,6 +19,7 @@
 #include "grid.h"
 
 #include "random_generator.h"
+#include "simulator_observer.h"
 
 struct IdentifiedMagnet : public Identifiable, public Magnet{
     public:
@@ -41,6 +44,13 @@ class EmbeddablePlane : public Plane<T>{
         void initEmbed(std::shared_ptr<const Graph<T>> graph);
         bool stepForceDirected();
         bool stepForceDirectedStable();
+        // Runs the remaining iterations, same spots as calling stepForceDirected until it returns false.
+        void runToCompletion();
+        // Iterates until the deadline passes or the embedding is done and returns isEmbedding().
+        // An iteration may stop between its force phases, the next call or stepForceDirected finishes it.
+        bool stepForceDirectedUntil(std::chrono::steady_clock::time_point deadline);
+        template <typename Rep, typename Period>
+        bool stepForceDirectedFor(std::chrono::duration<Rep, Period> budget);
         void embedNode(Node<T> node, double x, double y);
         void embed(std::shared_ptr<const Graph<T>> graph);
         bool isEmbedding();
@@ -48,6 +58,9 @@ class EmbeddablePlane : public Plane<T>{
         void setupTempSpots();
         void calculateZoneRadius();
         void applyMagnetGrid(Grid<IdentifiedMagnet> magnetRelativePoses);
+        // Reports every force-directed iteration as a step to observer, nullptr detaches it.
+        // The spots committed by an iteration are its changed cells.
+        void setObserver(SimulatorObserver* observer);
 
     private:
         DoubleVector2 getClosestPointOnEdge(const DoubleVector2 point, const DoubleVector2 end1, const DoubleVector2 end2);
@@ -58,14 +71,30 @@ class EmbeddablePlane : public Plane<T>{
         void applyEdgeRepulse(double temperature);
         void applyMagnetForces(double temperature);
         void applyAttraction(double temperature);
+        // Runs the phases of the current iteration from iterationPhase. With a deadline it returns false
+        // if the deadline passed before the last phase, the iteration then resumes from the next phase.
+        bool iterateForceDirected(std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt);
+        // iterateForceDirected between the observer calls
+        bool observedIterate(std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt);
+        long long getIterationsDone() const;
 
         
         int currentIteration = -1;
+        enum class ForcePhase{
+            repulse,
+            attraction,
+            magnets,
+            commit
+        };
+        ForcePhase iterationPhase = ForcePhase::repulse;
         double idealLength = 5.0;
         
         std::shared_ptr<const Graph<T>> currentGraph;
-        std::unordered_map<Identifiable, Spot<T>, IDHash> temp_spots;
+        IDMap<Spot<T>> temp_spots;
         std::vector<IdentifiedMagnet> magnets;
+        SimulatorObserver* observer = nullptr;
+        StepObservation observation;
+        long long committedSpots = 0;
         
         const int iterationsMax = 100;
         const int repulsionEdgeIterationsMax = 100;
@@ -110,6 +139,7 @@ template<typename T> void EmbeddablePlane<T>::initEmbed(std::shared_ptr<const Gr
         }
     }
     currentIteration = 0;
+    iterationPhase = ForcePhase::repulse;
 }
 
 template<typename T> bool EmbeddablePlane<T>::stepForceDirected(){
@@ -117,27 +147,101 @@ template<typename T> bool EmbeddablePlane<T>::stepForceDirected(){
         return false;
     }
 
-    updateTempSpots();
+    // The forces of a partly done iteration are kept in temp_spots
+    if (iterationPhase == ForcePhase::repulse)
+        updateTempSpots();
+    observedIterate();
+    return true;
+}
 
+template<typename T> void EmbeddablePlane<T>::runToCompletion(){
+    if (currentIteration == -1){
+        return;
+    }
+    // commitSpots copies temp_spots into the spots, so they only need to be copied back once
+    if (iterationPhase == ForcePhase::repulse)
+        updateTempSpots();
+    while (currentIteration != -1){
+        observedIterate();
+    }
+}
+
+template<typename T> bool EmbeddablePlane<T>::stepForceDirectedUntil(std::chrono::steady_clock::time_point deadline){
+    if (currentIteration == -1){
+        return false;
+    }
+    do{
+        if (iterationPhase == ForcePhase::repulse)
+            updateTempSpots();
+        if (!observedIterate(deadline))
+            return true;
+    } while (currentIteration != -1 && std::chrono::steady_clock::now() < deadline);
+    return isEmbedding();
+}
+
+template<typename T>
+template <typename Rep, typename Period>
+bool EmbeddablePlane<T>::stepForceDirectedFor(std::chrono::duration<Rep, Period> budget){
+    return stepForceDirectedUntil(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget));
+}
+
+template<typename T> bool EmbeddablePlane<T>::iterateForceDirected(std::optional<std::chrono::steady_clock::time_point> deadline){
     double attractiveTemperature = (1.0 - (double)currentIteration/iterationsMax) + minimumTemperature;
     double repulsionTemperature = (1.0 - (double)currentIteration/repulsionIterationsMax) + minimumTemperature;
     double magnetTemperature = ((double)currentIteration/repulsionIterationsMax) + minimumTemperature;
 
-    applyRepulse(repulsionTemperature);
-    applyAttraction(attractiveTemperature);
-    applyMagnetForces(magnetTemperature);
-
-    for (Identifiable id : this->getIDs()) {
-        clampToBorder(id);
+    while (true){
+        switch (iterationPhase){
+            case ForcePhase::repulse:
+                applyRepulse(repulsionTemperature);
+                iterationPhase = ForcePhase::attraction;
+                break;
+            case ForcePhase::attraction:
+                applyAttraction(attractiveTemperature);
+                iterationPhase = ForcePhase::magnets;
+                break;
+            case ForcePhase::magnets:
+                applyMagnetForces(magnetTemperature);
+                iterationPhase = ForcePhase::commit;
+                break;
+            case ForcePhase::commit:
+                for (Identifiable id : this->getIDs()) {
+                    clampToBorder(id);
+                }
+                this->commitSpots();
+                iterationPhase = ForcePhase::repulse;
+                currentIteration++;
+                if (currentIteration >= repulsionIterationsMax)
+                    currentIteration = -1;
+                return true;
+        }
+        if (deadline && std::chrono::steady_clock::now() >= *deadline)
+            return false;
     }
+}
 
-    this->commitSpots();
-    currentIteration++;
-    if (currentIteration >= repulsionIterationsMax)
-        currentIteration = -1;
+template<typename T> bool EmbeddablePlane<T>::observedIterate(std::optional<std::chrono::steady_clock::time_point> deadline){
+    if (!observer)
+        return iterateForceDirected(deadline);
+    observation.begin(*observer, getIterationsDone() + 1, committedSpots, 0);
+    if (!iterateForceDirected(deadline)){
+        observation.pause();
+        return false;
+    }
+    committedSpots += this->getSpotsNumber();
+    observation.end(*observer, getIterationsDone(), committedSpots, 0);
     return true;
 }
 
+template<typename T> long long EmbeddablePlane<T>::getIterationsDone() const{
+    return currentIteration == -1 ? repulsionIterationsMax : currentIteration;
+}
+
+template<typename T> void EmbeddablePlane<T>::setObserver(SimulatorObserver* observer){
+    this->observer = observer;
+    observation.reset(committedSpots);
+}
+
 template<typename T> bool EmbeddablePlane<T>::stepForceDirectedStable(){
     if (currentIteration == -1)
         return false;
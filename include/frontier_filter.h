@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include "2d.h"
+
+// Drops frontier pushes which can't change the bloat result and counts pushes before and after.
+// A push of a tile which is already set is always dropped, its entry would be skipped when bloated.
+// With enqueueOnce a tile is also pushed only once, the policy must then bloat a tile the same way
+// whichever entry reaches it first, and the first pushed entry is the first to be bloated anyway.
+class FrontierFilter{
+    public:
+        FrontierFilter() = default;
+        FrontierFilter(int width, int height);
+
+        void setEnqueueOnce(bool enqueueOnce);
+        bool isEnqueueOnce() const{return enqueueOnce;};
+
+        bool accept(IntVector2 point, bool isEmpty){
+            attemptedPushes++;
+            if (!isEmpty){
+                return false;
+            }
+            if (enqueueOnce){
+                std::vector<bool>::reference bit = enqueued[point.y * width + point.x];
+                if (bit){
+                    return false;
+                }
+                bit = true;
+            }
+            acceptedPushes++;
+            return true;
+        }
+
+        // Pushes since construction or clear(), divided by the tile count they give pushes per tile.
+        long long getAttemptedPushes() const{return attemptedPushes;};
+        long long getAcceptedPushes() const{return acceptedPushes;};
+        void clear();
+
+    private:
+        int width = 0;
+        bool enqueueOnce = false;
+        std::vector<bool> enqueued;
+        long long attemptedPushes = 0;
+        long long acceptedPushes = 0;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <utility>
+#include <stdexcept>
+
+// Lazy coroutine generator, a minimal std::generator for the compilers we support which don't ship it yet.
+// The coroutine only runs when the next value is asked for and destroying the generator cancels it,
+// freeing its frame. A yielded value is seen by reference and stays valid until the generator is resumed.
+template <typename T>
+class Generator{
+    public:
+        struct promise_type{
+            const T* value = nullptr;
+            std::exception_ptr exception;
+
+            Generator get_return_object(){return Generator(std::coroutine_handle<promise_type>::from_promise(*this));};
+            std::suspend_always initial_suspend() noexcept{return {};};
+            std::suspend_always final_suspend() noexcept{return {};};
+            std::suspend_always yield_value(const T& yielded) noexcept{
+                value = &yielded;
+                return {};
+            };
+            void return_void() noexcept{};
+            void unhandled_exception(){exception = std::current_exception();};
+        };
+
+        class Iterator{
+            public:
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+
+                Iterator() = default;
+                explicit Iterator(Generator* generator) : generator{generator}{};
+
+                const T& operator*() const{return generator->value();};
+                const T* operator->() const{return &generator->value();};
+                Iterator& operator++(){
+                    generator->next();
+                    return *this;
+                };
+                void operator++(int){++*this;};
+                bool operator==(std::default_sentinel_t) const{return generator->isDone();};
+
+            private:
+                Generator* generator = nullptr;
+        };
+
+        Generator(Generator&& other) noexcept : handle{std::exchange(other.handle, nullptr)}{};
+        Generator& operator=(Generator&& other) noexcept{
+            if (this != &other){
+                destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        };
+        Generator(const Generator&) = delete;
+        Generator& operator=(const Generator&) = delete;
+        ~Generator(){destroy();};
+
+        // Runs the coroutine up to its next yield, false once it has returned. Rethrows what the coroutine threw.
+        bool next();
+        // The last yielded value, throws std::logic_error before the first yield and after the return.
+        const T& value() const;
+        bool isDone() const{return !handle || handle.done();};
+
+        // Starts the coroutine, so begin() may only be called once.
+        Iterator begin();
+        std::default_sentinel_t end(){return {};};
+
+    private:
+        explicit Generator(std::coroutine_handle<promise_type> handle) : handle{handle}{};
+        void destroy();
+
+        std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+bool Generator<T>::next(){
+    if (isDone()){
+        return false;
+    }
+    handle.promise().value = nullptr;
+    handle.resume();
+    if (handle.promise().exception){
+        std::rethrow_exception(std::exchange(handle.promise().exception, nullptr));
+    }
+    return !handle.done();
+}
+
+template <typename T>
+const T& Generator<T>::value() const{
+    if (isDone() || !handle.promise().value){
+        throw std::logic_error("Generator has no value");
+    }
+    return *handle.promise().value;
+}
+
+template <typename T>
+typename Generator<T>::Iterator Generator<T>::begin(){
+    next();
+    return Iterator(this);
+}
+
+template <typename T>
+void Generator<T>::destroy(){
+    if (handle){
+        handle.destroy();
+        handle = nullptr;
+    }
+}
@@ -4,6 +4,7 @@
 #include <set>
 
 #include "identifiable.h"
+#include "id_map.h"
 
 template<hasID T>
 class Node{
@@ -43,7 +44,7 @@ class Graph{
         int size() const;
     protected:
         std::vector<Identifiable> ids;
-        std::unordered_map<Identifiable, Node<T>, IDHash> nodes;
+        IDMap<Node<T>> nodes;
     private:
 };
 
@@ -110,10 +111,10 @@ Graph<T>::Graph(const std::vector<std::pair<T, std::vector<Identifiable>>>& rawG
 template<hasID T>
 Graph<T>::Graph(std::vector<Node<T>> nodes_vec){
     nodes.reserve(nodes_vec.size());
-    ids.reserve(nodes.size());
+    ids.reserve(nodes_vec.size());
     for (const auto& node : nodes_vec){
-        nodes.push_back(node);
-        ids.push_back(static_cast<Identifiable>(node));
+        nodes[node.getID()] = node;
+        ids.push_back(node.getID());
     }
 }
 
@@ -1,13 +1,14 @@
 #pragma once
 
 #include <vector>
-#include <unordered_map>
 #include <optional>
 
 #include <iostream>
 
 #include "2d.h"
 #include "identifiable.h"
+#include "zone_statistics.h"
+#include "id_map.h"
 
 
 #include <exception>
@@ -52,6 +53,14 @@ class Grid{
         bool isEmpty(int x, int y);
         bool isEmpty(IntVector2 point);
 
+        // Kept up to date by setTile, queries are O(1).
+        const ZoneStatistics& getZoneStatistics() const;
+        int getZoneArea(Identifiable zone) const;
+        ZoneBounds getZoneBounds(Identifiable zone) const;
+        DoubleVector2 getZoneCentroid(Identifiable zone) const;
+        // Tiles setTile changed since construction, a running total for telling how many tiles a pass changed.
+        long long getChangeCount() const;
+
         std::vector<T> applyToDoublePoints(DoubleVector2 size);
 
         bool isValidPoint(IntVector2 point2) const;
@@ -69,7 +78,8 @@ class Grid{
                 int getY() const{return y;};
                 void move(int x, int y){this->y += y; this->x += x;};
                 Iterator(Grid& grid, int x, int y) : grid(grid), x(x), y(y){}
-                Identifiable& operator*(){return grid.matrix[y][x];}
+                // Read-only, writes go through Grid::setTile(it, value) to keep the statistics valid
+                const Identifiable operator*() const{return grid.matrix[y][x];}
                 Iterator& operator++();
                 Iterator& operator--();
                 bool operator==(const Iterator& other) const;
@@ -102,8 +112,10 @@ class Grid{
         int width = -1;
         int height = -1;
         std::vector<std::vector<Identifiable>> matrix;
-        std::unordered_map<Identifiable, T, IDHash> tileset;
+        IDMap<T> tileset;
         std::vector<Identifiable> tileIDs;
+        ZoneStatistics statistics;
+        long long changeCount = 0;
 };
 
 template <typename T>
@@ -162,7 +174,7 @@ bool Grid<T>::ConstIterator::operator==(const ConstIterator &other) const{
 }
 
 template <typename T> 
-Grid<T>::Grid(int width, int height) : width(width), height(height){
+Grid<T>::Grid(int width, int height) : width(width), height(height), statistics(width, height){
     matrix = std::vector<std::vector<Identifiable>>(height, std::vector<Identifiable>(width));
 }
 
@@ -176,6 +188,7 @@ Grid<T>::Grid(const std::vector<std::vector<T>>& matrix){
     size_t height = matrix.size();
     size_t width = matrix[0].size();
     this->matrix = std::vector<std::vector<Identifiable>>(height);
+    statistics = ZoneStatistics(width, height);
     for (int y = 0; y < height; y++){
         this->matrix[y].reserve(width);
         for (int x = 0 ; x < width; x++){
@@ -185,6 +198,7 @@ Grid<T>::Grid(const std::vector<std::vector<T>>& matrix){
                 tileIDs.push_back(static_cast<Identifiable>(value));
             }
             this->matrix[y].push_back(matrix[y][x]);
+            statistics.change(Identifiable::nullID, value, x, y);
         }
     }
     this->width = width;
@@ -204,12 +218,18 @@ void Grid<T>::checkTilesetValidness(Identifiable id) const
 
 template <typename T>
 void Grid<T>::setTile(int x, int y, Identifiable value){
-    matrix.at(y).at(x) = value;
+    Identifiable& tile = matrix.at(y).at(x);
+    if (tile == value){
+        return;
+    }
+    statistics.change(tile, value, x, y);
+    tile = value;
+    changeCount++;
 }
 
 template <typename T>
 void Grid<T>::setTile(IntVector2 point, Identifiable value){
-    matrix.at(point.y).at(point.x) = value;
+    setTile(point.x, point.y, value);
 }
 
 template <typename T> void Grid<T>::setTile(typename Grid<T>::Iterator it, Identifiable value){
@@ -253,6 +273,31 @@ int Grid<T>::getHeight() const{
     return height;
 }
 
+template <typename T>
+const ZoneStatistics& Grid<T>::getZoneStatistics() const{
+    return statistics;
+}
+
+template <typename T>
+long long Grid<T>::getChangeCount() const{
+    return changeCount;
+}
+
+template <typename T>
+int Grid<T>::getZoneArea(Identifiable zone) const{
+    return statistics.getArea(zone);
+}
+
+template <typename T>
+ZoneBounds Grid<T>::getZoneBounds(Identifiable zone) const{
+    return statistics.getBounds(zone);
+}
+
+template <typename T>
+DoubleVector2 Grid<T>::getZoneCentroid(Identifiable zone) const{
+    return statistics.getCentroid(zone);
+}
+
 template <typename T>
 bool Grid<T>::isEmpty(int x, int y){
     return matrix.at(y).at(x) == Identifiable::nullID;
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <utility>
+#include <tuple>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+
+#include "identifiable.h"
+
+// Flat map indexed by ID, with the interface of std::unordered_map<Identifiable, V, IDHash> for small dense IDs.
+// Lookups are a bounds check and an offset, iteration goes in ascending ID order.
+// Memory is proportional to the range between the smallest and the largest key ever inserted.
+// Unlike std::unordered_map, an insert of a key outside of the current ID range reallocates the slots and
+// invalidates every reference and iterator, so don't keep map[id] references across inserts of new keys.
+template <typename V>
+class IDMap{
+    public:
+        using key_type = Identifiable;
+        using mapped_type = V;
+        using value_type = std::pair<const Identifiable, V>;
+        using size_type = size_t;
+
+        template <bool isConst>
+        class BasicIterator;
+        using iterator = BasicIterator<false>;
+        using const_iterator = BasicIterator<true>;
+
+        IDMap() = default;
+        IDMap(std::initializer_list<value_type> values);
+        IDMap(const IDMap& other) = default;
+        IDMap(IDMap&& other) noexcept = default;
+        IDMap& operator=(const IDMap& other);
+        IDMap& operator=(IDMap&& other) noexcept = default;
+
+        V& operator[](Identifiable id);
+        V& at(Identifiable id);
+        const V& at(Identifiable id) const;
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(Identifiable id, Args&&... args);
+        template <typename... Args>
+        std::pair<iterator, bool> emplace(Identifiable id, Args&&... args);
+        std::pair<iterator, bool> insert(const value_type& value);
+        size_t erase(Identifiable id);
+
+        size_t count(Identifiable id) const;
+        bool contains(Identifiable id) const;
+        iterator find(Identifiable id);
+        const_iterator find(Identifiable id) const;
+
+        size_t size() const{return elementCount;};
+        bool empty() const{return elementCount == 0;};
+        void clear();
+        // Reserves room for count consecutive IDs.
+        void reserve(size_t count);
+
+        iterator begin(){return iterator(slots.data(), slots.data() + slots.size());};
+        iterator end(){return iterator(slots.data() + slots.size(), slots.data() + slots.size());};
+        const_iterator begin() const{return const_iterator(slots.data(), slots.data() + slots.size());};
+        const_iterator end() const{return const_iterator(slots.data() + slots.size(), slots.data() + slots.size());};
+
+        template <bool isConst>
+        class BasicIterator{
+            using Slot = std::conditional_t<isConst, const std::optional<IDMap::value_type>, std::optional<IDMap::value_type>>;
+            using Value = std::conditional_t<isConst, const IDMap::value_type, IDMap::value_type>;
+            private:
+                Slot* current = nullptr;
+                Slot* last = nullptr;
+                void skipEmpty(){while (current != last && !current->has_value()) current++;};
+            public:
+                using value_type = IDMap::value_type;
+                using difference_type = std::ptrdiff_t;
+                using reference = Value&;
+                using pointer = Value*;
+                using iterator_category = std::forward_iterator_tag;
+
+                BasicIterator() = default;
+                BasicIterator(Slot* current, Slot* last) : current(current), last(last){skipEmpty();}
+                operator BasicIterator<true>() const requires (!isConst){return BasicIterator<true>(current, last);}
+
+                Value& operator*() const{return **current;}
+                Value* operator->() const{return &**current;}
+                BasicIterator& operator++(){current++; skipEmpty(); return *this;}
+                BasicIterator operator++(int){BasicIterator copy = *this; ++*this; return copy;}
+                bool operator==(const BasicIterator& other) const{return current == other.current;}
+        };
+
+    private:
+        // Slot index of the ID, or -1 when it is out of the stored range.
+        long long slotIndex(Identifiable id) const;
+        std::optional<value_type>& ensureSlot(Identifiable id);
+
+        std::vector<std::optional<value_type>> slots;
+        int base = 0;
+        size_t elementCount = 0;
+};
+
+template <typename V>
+IDMap<V>::IDMap(std::initializer_list<value_type> values){
+    for (const value_type& value : values){
+        insert(value);
+    }
+}
+
+// Slots are not assignable because of the const key, so the copy rebuilds them in place keeping the capacity.
+template <typename V>
+IDMap<V>& IDMap<V>::operator=(const IDMap& other){
+    if (this == &other){
+        return *this;
+    }
+    slots.clear();
+    slots.reserve(other.slots.size());
+    for (const auto& slot : other.slots){
+        slots.push_back(slot);
+    }
+    base = other.base;
+    elementCount = other.elementCount;
+    return *this;
+}
+
+template <typename V>
+V& IDMap<V>::operator[](Identifiable id){
+    return try_emplace(id).first->second;
+}
+
+template <typename V>
+V& IDMap<V>::at(Identifiable id){
+    long long index = slotIndex(id);
+    if (index < 0 || !slots[index]){
+        throw std::out_of_range("IDMap::at: no value for ID " + id.toString());
+    }
+    return slots[index]->second;
+}
+
+template <typename V>
+const V& IDMap<V>::at(Identifiable id) const{
+    long long index = slotIndex(id);
+    if (index < 0 || !slots[index]){
+        throw std::out_of_range("IDMap::at: no value for ID " + id.toString());
+    }
+    return slots[index]->second;
+}
+
+template <typename V>
+template <typename... Args>
+std::pair<typename IDMap<V>::iterator, bool> IDMap<V>::try_emplace(Identifiable id, Args&&... args){
+    std::optional<value_type>& slot = ensureSlot(id);
+    bool inserted = false;
+    if (!slot){
+        slot.emplace(std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple(std::forward<Args>(args)...));
+        elementCount++;
+        inserted = true;
+    }
+    return {iterator(&slot, slots.data() + slots.size()), inserted};
+}
+
+template <typename V>
+template <typename... Args>
+std::pair<typename IDMap<V>::iterator, bool> IDMap<V>::emplace(Identifiable id, Args&&... args){
+    return try_emplace(id, std::forward<Args>(args)...);
+}
+
+template <typename V>
+std::pair<typename IDMap<V>::iterator, bool> IDMap<V>::insert(const value_type& value){
+    return try_emplace(value.first, value.second);
+}
+
+template <typename V>
+size_t IDMap<V>::erase(Identifiable id){
+    long long index = slotIndex(id);
+    if (index < 0 || !slots[index]){
+        return 0;
+    }
+    slots[index].reset();
+    elementCount--;
+    return 1;
+}
+
+template <typename V>
+size_t IDMap<V>::count(Identifiable id) const{
+    long long index = slotIndex(id);
+    return index >= 0 && slots[index] ? 1 : 0;
+}
+
+template <typename V>
+bool IDMap<V>::contains(Identifiable id) const{
+    return count(id) == 1;
+}
+
+template <typename V>
+typename IDMap<V>::iterator IDMap<V>::find(Identifiable id){
+    long long index = slotIndex(id);
+    if (index < 0 || !slots[index]){
+        return end();
+    }
+    return iterator(slots.data() + index, slots.data() + slots.size());
+}
+
+template <typename V>
+typename IDMap<V>::const_iterator IDMap<V>::find(Identifiable id) const{
+    long long index = slotIndex(id);
+    if (index < 0 || !slots[index]){
+        return end();
+    }
+    return const_iterator(slots.data() + index, slots.data() + slots.size());
+}
+
+template <typename V>
+void IDMap<V>::clear(){
+    slots.clear();
+    base = 0;
+    elementCount = 0;
+}
+
+template <typename V>
+void IDMap<V>::reserve(size_t count){
+    slots.reserve(count);
+}
+
+template <typename V>
+long long IDMap<V>::slotIndex(Identifiable id) const{
+    long long index = static_cast<long long>(id.getID()) - base;
+    if (index < 0 || index >= static_cast<long long>(slots.size())){
+        return -1;
+    }
+    return index;
+}
+
+template <typename V>
+std::optional<typename IDMap<V>::value_type>& IDMap<V>::ensureSlot(Identifiable id){
+    int key = id.getID();
+    if (slots.empty()){
+        base = key;
+    }
+    if (key < base){
+        // Growing to the front moves every slot, double the range so descending inserts stay amortized O(1)
+        size_t shift = std::max(static_cast<size_t>(static_cast<long long>(base) - key), slots.size());
+        shift = std::min(shift, static_cast<size_t>(static_cast<long long>(base) - std::numeric_limits<int>::min()));
+        std::vector<std::optional<value_type>> grown;
+        grown.reserve(slots.size() + shift);
+        grown.resize(shift);
+        for (auto& slot : slots){
+            grown.push_back(std::move(slot));
+        }
+        slots = std::move(grown);
+        base -= static_cast<int>(shift);
+    }
+    size_t index = static_cast<size_t>(static_cast<long long>(key) - base);
+    if (index >= slots.size()){
+        slots.resize(index + 1);
+    }
+    return slots[index];
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include <cstdlib>
+#include <algorithm>
+
+#include "grid.h"
+#include "identifiable.h"
+#include "simulator.h"
+#include "thread_pool.h"
+
+// Approximate Voronoi partition by jump flooding. Each step is one pass over the whole grid where every cell
+// looks at 8 cells at the current stride and keeps the nearest seed found, the stride halves every step.
+// A grid with the larger side N takes ceil(log2 N) steps instead of one step per BFS layer.
+// With correction a stride 1 pass runs first (1+JFA), which fixes most of the misassigned cells.
+// The grid is written on the last step, ties go to the lower zone ID, then to the seed found first in raster order.
+template <typename T>
+class JumpFlooder : public Simulator{
+    public:
+        enum class Metric{
+            euclidean,
+            manhattan, // same partition as StraightBloat up to ties
+            chebyshev  // same partition as ChebyshevBloat up to ties
+        };
+
+        //Empty grid tiles are considered NullID
+        void initVoronoi(std::shared_ptr<Grid<T>> initialGrid, Metric metric = Metric::euclidean, bool correction = false);
+        void onStart() override;
+        void onStep() override;
+        void onReset() override;
+        void finishAndReset();
+
+        std::shared_ptr<Grid<T>> getGrid() const;
+        int getPassCount() const;
+
+        // Passes are split over the pool by rows, the result doesn't depend on the thread count.
+        void enableParallelStep(ThreadPool& pool = ThreadPool::instance());
+        void disableParallelStep();
+
+    private:
+        static constexpr int noSeed = -1;
+
+        template <Metric metric>
+        long long distance(int seed, int x, int y) const;
+        void pass(int stride);
+        template <Metric metric>
+        void passRows(int stride, int rowBegin, int rowEnd);
+        void writeGrid();
+
+        std::shared_ptr<Grid<T>> grid;
+        Metric metric = Metric::euclidean;
+        ThreadPool* pool = nullptr;
+
+        std::vector<IntVector2> seedPoints;
+        std::vector<Identifiable> seedZones;
+        // Seed index per cell, swapped after every pass
+        std::vector<int> nearest;
+        std::vector<int> nextNearest;
+        std::vector<int> strides;
+        size_t nextPass = 0;
+};
+
+template <typename T>
+void JumpFlooder<T>::initVoronoi(std::shared_ptr<Grid<T>> initialGrid, Metric metric, bool correction){
+    grid = initialGrid;
+    this->metric = metric;
+    int width = grid->getWidth();
+    int height = grid->getHeight();
+
+    seedPoints.clear();
+    seedZones.clear();
+    nearest.assign(static_cast<size_t>(width) * height, noSeed);
+    nextNearest.assign(nearest.size(), noSeed);
+    for (auto it = grid->begin(); it != grid->end(); ++it){
+        if (*it != Identifiable::nullID){
+            nearest[it.getY() * width + it.getX()] = seedPoints.size();
+            seedPoints.push_back({it.getX(), it.getY()});
+            seedZones.push_back(*it);
+        }
+    }
+
+    strides.clear();
+    if (correction){
+        strides.push_back(1);
+    }
+    int size = std::max(width, height);
+    int stride = 1;
+    while (stride < size){
+        stride *= 2;
+    }
+    for (stride /= 2; stride >= 1; stride /= 2){
+        strides.push_back(stride);
+    }
+    nextPass = 0;
+}
+
+template <typename T>
+void JumpFlooder<T>::onStart(){
+    if (!grid){
+        finish();
+        throw std::invalid_argument("No grid is set!");
+    }
+}
+
+template <typename T>
+void JumpFlooder<T>::onStep(){
+    if (nextPass < strides.size() && !seedPoints.empty()){
+        pass(strides[nextPass]);
+        nextPass++;
+    }
+    if (nextPass >= strides.size() || seedPoints.empty()){
+        writeGrid();
+        finish();
+    }
+}
+
+template <typename T>
+void JumpFlooder<T>::onReset(){
+    seedPoints.clear();
+    seedZones.clear();
+    nearest.clear();
+    nextNearest.clear();
+    strides.clear();
+    nextPass = 0;
+}
+
+template <typename T>
+void JumpFlooder<T>::finishAndReset(){
+    if (isRunning())
+        finish();
+    if (isFinished())
+        reset();
+}
+
+template <typename T>
+std::shared_ptr<Grid<T>> JumpFlooder<T>::getGrid() const{
+    return grid;
+}
+
+template <typename T>
+int JumpFlooder<T>::getPassCount() const{
+    return strides.size();
+}
+
+template <typename T>
+void JumpFlooder<T>::enableParallelStep(ThreadPool& pool){
+    this->pool = &pool;
+}
+
+template <typename T>
+void JumpFlooder<T>::disableParallelStep(){
+    pool = nullptr;
+}
+
+template <typename T>
+template <typename JumpFlooder<T>::Metric metric>
+long long JumpFlooder<T>::distance(int seed, int x, int y) const{
+    long long dx = std::abs(seedPoints[seed].x - x);
+    long long dy = std::abs(seedPoints[seed].y - y);
+    if constexpr (metric == Metric::manhattan){
+        return dx + dy;
+    } else if constexpr (metric == Metric::chebyshev){
+        return std::max(dx, dy);
+    } else{
+        return dx * dx + dy * dy;
+    }
+}
+
+template <typename T>
+void JumpFlooder<T>::pass(int stride){
+    auto rows = [this, stride](size_t, size_t rowBegin, size_t rowEnd){
+        switch (metric){
+            case Metric::manhattan:
+                passRows<Metric::manhattan>(stride, rowBegin, rowEnd);
+                break;
+            case Metric::chebyshev:
+                passRows<Metric::chebyshev>(stride, rowBegin, rowEnd);
+                break;
+            default:
+                passRows<Metric::euclidean>(stride, rowBegin, rowEnd);
+        }
+    };
+    int height = grid->getHeight();
+    if (pool){
+        pool->parallelFor(height, rows);
+    } else{
+        rows(0, 0, height);
+    }
+    nearest.swap(nextNearest);
+}
+
+template <typename T>
+template <typename JumpFlooder<T>::Metric metric>
+void JumpFlooder<T>::passRows(int stride, int rowBegin, int rowEnd){
+    int width = grid->getWidth();
+    int height = grid->getHeight();
+    for (int y = rowBegin; y < rowEnd; y++){
+        for (int x = 0; x < width; x++){
+            int best = nearest[y * width + x];
+            long long bestDistance = best == noSeed ? 0 : distance<metric>(best, x, y);
+            for (int dy = -stride; dy <= stride; dy += stride){
+                int ny = y + dy;
+                if (ny < 0 || ny >= height){
+                    continue;
+                }
+                for (int dx = -stride; dx <= stride; dx += stride){
+                    int nx = x + dx;
+                    if (nx < 0 || nx >= width || (dx == 0 && dy == 0)){
+                        continue;
+                    }
+                    int candidate = nearest[ny * width + nx];
+                    if (candidate == noSeed || candidate == best){
+                        continue;
+                    }
+                    long long candidateDistance = distance<metric>(candidate, x, y);
+                    bool closer = best == noSeed
+                        || candidateDistance < bestDistance
+                        || (candidateDistance == bestDistance && (
+                            seedZones[candidate] < seedZones[best]
+                            || (seedZones[candidate] == seedZones[best] && candidate < best)
+                        ));
+                    if (closer){
+                        best = candidate;
+                        bestDistance = candidateDistance;
+                    }
+                }
+            }
+            nextNearest[y * width + x] = best;
+        }
+    }
+}
+
+template <typename T>
+void JumpFlooder<T>::writeGrid(){
+    int width = grid->getWidth();
+    for (int y = 0; y < grid->getHeight(); y++){
+        for (int x = 0; x < width; x++){
+            int seed = nearest[y * width + x];
+            if (seed != noSeed){
+                grid->setTile(x, y, seedZones[seed]);
+            }
+        }
+    }
+}
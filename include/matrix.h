@@ -6,6 +6,8 @@
 #include <unordered_map>
 #include <ranges>
 #include <stdexcept>
+#include <limits>
+#include <algorithm>
 
 
 template<typename T>
@@ -61,6 +63,9 @@ class Matrix{
         int getHeight() const;
 
         Matrix(const Matrix& other);
+        Matrix(Matrix&& other) noexcept = default;
+        Matrix& operator=(const Matrix& other) = default;
+        Matrix& operator=(Matrix&& other) noexcept = default;
 
         bool isValidPoint(IntVector2 point2) const;
 
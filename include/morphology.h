@@ -192,9 +192,9 @@ namespace morphology{
     void apply(Grid<T>& grid, const Matrix<bool>& boolMap, Identifiable tile){
         for (auto it = grid.begin(); it != grid.end(); ++it){
             if (boolMap.get(it.getX(),it.getY())){
-                *it = tile;
+                grid.setTile(it, tile);
             } else if (*it == tile){
-                *it = Identifiable::nullID;
+                grid.setTile(it, Identifiable::nullID);
             }
         }
     }
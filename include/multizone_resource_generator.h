@@ -1,24 +1,24 @@
 #pragma once
 
-#include <unordered_map>
 #include <vector>
 
 #include "identifiable.h"
+#include "id_map.h"
 #include "resource_generator.h"
 #include "matrix.h"
 
 template <typename T>
 class MultizoneResourceGenerator{
 private:
-    std::unordered_map<Identifiable, ResourceGenerator<T>, IDHash> zones;
-    std::unordered_map<Identifiable, Matrix<double>, IDHash> masks;
+    IDMap<ResourceGenerator<T>> zones;
+    IDMap<Matrix<double>> masks;
     IntVector2 dimension;
     std::vector<ResourceMapping<T>> getAverageResourceMapping(IntVector2 point);
 
 public:
     void setup(
-        const std::unordered_map<Identifiable, ResourceGenerator<T>, IDHash>& zones,
-        const std::unordered_map<Identifiable, Matrix<double>, IDHash>& masks
+        const IDMap<ResourceGenerator<T>>& zones,
+        const IDMap<Matrix<double>>& masks
     );
 
     MultizoneResourceGenerator(){};
@@ -28,8 +28,8 @@ public:
 
 template <typename T>
 void MultizoneResourceGenerator<T>::setup(
-    const std::unordered_map<Identifiable, ResourceGenerator<T>, IDHash> &zones,
-    const std::unordered_map<Identifiable, Matrix<double>, IDHash> &masks)
+    const IDMap<ResourceGenerator<T>> &zones,
+    const IDMap<Matrix<double>> &masks)
 {
     if (zones.size() != masks.size()){
         throw std::invalid_argument(std::format("Zones size ({}) doesn't match masks size ({})", zones.size(), masks.size()));
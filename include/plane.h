@@ -2,6 +2,7 @@
 #include <vector>
 #include <stdexcept>
 #include "spot.h"
+#include "id_map.h"
 
 constexpr int ID_LIMIT = 1000;
 
@@ -26,7 +27,7 @@ public:
         clear();
         insertSpots(spots);
     }
-    void updateSpots(const std::unordered_map<Identifiable, Spot<T>, IDHash>& spots){
+    void updateSpots(const IDMap<Spot<T>>& spots){
         this->spots = spots;
     }
 
@@ -103,7 +104,7 @@ public:
     }
 
 private:
-    std::unordered_map<Identifiable,Spot<T>,IDHash> spots;
+    IDMap<Spot<T>> spots;
     std::vector<Identifiable> ids;
     double leftX = 0;
     double upperY = 0;
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+
+#include "grid.h"
+#include "matrix.h"
+#include "identifiable.h"
+#include "id_map.h"
+#include "simulator.h"
+#include "radial.h"
+#include "bloat_policy.h"
+#include "bucket_queue.h"
+
+// Weighted Voronoi bloat. Tiles are claimed in the order of their cost from the seed, kept in a BucketQueue,
+// and each step claims the whole lowest cost bucket. A tile claimed by several zones at the same cost goes
+// to the one pushed first, seeds are pushed in raster order.
+// With T deriving from Radial the zone radius sets its growth, otherwise every zone grows at the same speed.
+// A cost field makes the moves into some tiles more expensive or impossible, e.g. for mountains and water.
+template <typename T>
+class PriorityZoneBloater : public Simulator{
+    public:
+        enum class Weighting{
+            multiplicative, // a move costs unitCost * maxRadius / radius, so zone size scales with its radius
+            additive        // a move costs unitCost, a zone starts (maxRadius - radius) * unitCost late
+        };
+        enum class Neighbourhood{
+            four,
+            eight // diagonal moves cost sqrt(2) times more, zones come out close to round
+        };
+        static constexpr int unitCost = 64;
+        // Larger tile weights are clamped to it, the queue keeps a bucket per cost up to the largest move cost.
+        static constexpr float maxTileWeight = 255.0f;
+        // Largest maxRadius / radius for multiplicative weighting, it keeps the largest move cost times
+        // maxTileWeight under 370k keys, so the queue ring stays within 2^19 buckets.
+        static constexpr double maxRadiusRatio = 16.0;
+
+        //Empty grid tiles are considered NullID
+        //Throws std::invalid_argument if a multiplicative radius is not positive or is over maxRadiusRatio times smaller than the largest.
+        void initWeightedVoronoi(std::shared_ptr<Grid<T>> initialGrid, Weighting weighting = Weighting::multiplicative, Neighbourhood neighbourhood = Neighbourhood::eight);
+        void onStart() override;
+        void onStep() override;
+        void onReset() override;
+        void finishAndReset();
+
+        // Entering a tile costs the move cost times the tile weight, a weight of 1 is plain ground.
+        // Tiles with weight 0 are impassable and stay empty unless they hold a seed. A diagonal move isn't taken
+        // when either of the two tiles beside it is impassable, so zones don't leak through diagonal walls.
+        // The field must match the grid size and is kept until cleared.
+        void setCostField(const Matrix<uint8_t>& weights);
+        // Weights which are not positive or not finite are impassable, weights above maxTileWeight are clamped to it.
+        void setCostField(const Matrix<float>& weights);
+        void clearCostField();
+
+        std::shared_ptr<Grid<T>> getGrid() const;
+        // Cost of the bucket claimed by the last step.
+        long long getCurrentCost() const;
+
+    private:
+        double getRadius(Identifiable zone) const;
+        void pushNeighbours(const ZoneTile& zoneTile, long long cost);
+        void pushIfEmpty(int x, int y, Identifiable zone, long long cost, long long moveCost);
+        void pushDiagonalIfEmpty(int x, int y, int dx, int dy, Identifiable zone, long long cost, long long moveCost);
+        bool isImpassable(int x, int y) const;
+
+        std::shared_ptr<Grid<T>> grid;
+        // Row-major, empty without a cost field, impassable tiles are 0
+        std::vector<float> tileWeights;
+        int costFieldWidth = 0;
+        int costFieldHeight = 0;
+        Neighbourhood neighbourhood = Neighbourhood::eight;
+        IDMap<long long> straightCosts;
+        IDMap<long long> diagonalCosts;
+
+        BucketQueue<ZoneTile> queue;
+        std::vector<ZoneTile> bucket;
+        long long currentCost = 0;
+};
+
+template <typename T>
+void PriorityZoneBloater<T>::initWeightedVoronoi(std::shared_ptr<Grid<T>> initialGrid, Weighting weighting, Neighbourhood neighbourhood){
+    grid = initialGrid;
+    this->neighbourhood = neighbourhood;
+    queue.clear();
+    straightCosts.clear();
+    diagonalCosts.clear();
+
+    std::vector<ZoneTile> seeds;
+    for (auto it = grid->begin(); it != grid->end(); ++it){
+        if (*it != Identifiable::nullID){
+            seeds.emplace_back(it.getX(), it.getY(), *it);
+            grid->setTile(it.getX(), it.getY(), Identifiable::nullID);
+        }
+    }
+    double maxRadius = 0;
+    for (const ZoneTile& seed : seeds){
+        double radius = getRadius(seed.zoneID);
+        if (weighting == Weighting::multiplicative && radius <= 0){
+            throw std::invalid_argument("Zone radius must be positive for multiplicative weighting");
+        }
+        maxRadius = std::max(maxRadius, radius);
+    }
+    if (weighting == Weighting::multiplicative){
+        for (const ZoneTile& seed : seeds){
+            if (maxRadius / getRadius(seed.zoneID) > maxRadiusRatio){
+                throw std::invalid_argument("Zone radius is more than maxRadiusRatio times smaller than the largest one");
+            }
+        }
+    }
+
+    IDMap<long long> startCosts;
+    for (const ZoneTile& seed : seeds){
+        double radius = getRadius(seed.zoneID);
+        double straightCost = unitCost;
+        long long startCost = 0;
+        if (weighting == Weighting::multiplicative){
+            straightCost = unitCost * maxRadius / radius;
+        } else{
+            startCost = std::llround((maxRadius - radius) * unitCost);
+        }
+        straightCosts[seed.zoneID] = std::max(1LL, std::llround(straightCost));
+        diagonalCosts[seed.zoneID] = std::max(1LL, std::llround(straightCost * std::sqrt(2.0)));
+        startCosts[seed.zoneID] = startCost;
+    }
+    for (const ZoneTile& seed : seeds){
+        queue.push(startCosts.at(seed.zoneID), seed);
+    }
+    currentCost = 0;
+}
+
+template <typename T>
+void PriorityZoneBloater<T>::onStart(){
+    if (!grid){
+        finish();
+        throw std::invalid_argument("No grid is set!");
+    }
+    if (!tileWeights.empty() && (costFieldWidth != grid->getWidth() || costFieldHeight != grid->getHeight())){
+        finish();
+        throw std::invalid_argument("Cost field size doesn't match the grid");
+    }
+}
+
+template <typename T>
+void PriorityZoneBloater<T>::onStep(){
+    if (queue.empty()){
+        finish();
+        return;
+    }
+    currentCost = queue.popBucket(bucket);
+    for (const ZoneTile& zoneTile : bucket){
+        if (!grid->isEmpty(zoneTile)){
+            continue;
+        }
+        grid->setTile(zoneTile, zoneTile.zoneID);
+        pushNeighbours(zoneTile, currentCost);
+    }
+    if (queue.empty()){
+        finish();
+    }
+}
+
+template <typename T>
+void PriorityZoneBloater<T>::onReset(){
+    queue.clear();
+    bucket.clear();
+    straightCosts.clear();
+    diagonalCosts.clear();
+    currentCost = 0;
+}
+
+template <typename T>
+void PriorityZoneBloater<T>::finishAndReset(){
+    if (isRunning())
+        finish();
+    if (isFinished())
+        reset();
+}
+
+template <typename T>
+void PriorityZoneBloater<T>::setCostField(const Matrix<uint8_t>& weights){
+    costFieldWidth = weights.getWidth();
+    costFieldHeight = weights.getHeight();
+    tileWeights.resize(static_cast<size_t>(costFieldWidth) * costFieldHeight);
+    for (int y = 0; y < costFieldHeight; y++){
+        for (int x = 0; x < costFieldWidth; x++){
+            tileWeights[y * costFieldWidth + x] = weights.get(x, y);
+        }
+    }
+}
+
+template <typename T>
+void PriorityZoneBloater<T>::setCostField(const Matrix<float>& weights){
+    costFieldWidth = weights.getWidth();
+    costFieldHeight = weights.getHeight();
+    tileWeights.resize(static_cast<size_t>(costFieldWidth) * costFieldHeight);
+    for (int y = 0; y < costFieldHeight; y++){
+        for (int x = 0; x < costFieldWidth; x++){
+            float weight = weights.get(x, y);
+            tileWeights[y * costFieldWidth + x] = std::isfinite(weight) && weight > 0 ? std::min(weight, maxTileWeight) : 0;
+        }
+    }
+}
+
+template <typename T>
+void PriorityZoneBloater<T>::clearCostField(){
+    tileWeights.clear();
+    costFieldWidth = 0;
+    costFieldHeight = 0;
+}
+
+template <typename T>
+std::shared_ptr<Grid<T>> PriorityZoneBloater<T>::getGrid() const{
+    return grid;
+}
+
+template <typename T>
+long long PriorityZoneBloater<T>::getCurrentCost() const{
+    return currentCost;
+}
+
+template <typename T>
+double PriorityZoneBloater<T>::getRadius(Identifiable zone) const{
+    if constexpr (std::is_base_of_v<Radial, T>){
+        return static_cast<const Radial&>(grid->getTile(zone)).getRadius();
+    } else{
+        return 1.0;
+    }
+}
+
+template <typename T>
+void PriorityZoneBloater<T>::pushNeighbours(const ZoneTile& zoneTile, long long cost){
+    int x = zoneTile.x;
+    int y = zoneTile.y;
+    long long straightCost = straightCosts.at(zoneTile.zoneID);
+    pushIfEmpty(x - 1, y, zoneTile.zoneID, cost, straightCost);
+    pushIfEmpty(x + 1, y, zoneTile.zoneID, cost, straightCost);
+    pushIfEmpty(x, y - 1, zoneTile.zoneID, cost, straightCost);
+    pushIfEmpty(x, y + 1, zoneTile.zoneID, cost, straightCost);
+    if (neighbourhood == Neighbourhood::four){
+        return;
+    }
+    long long diagonalCost = diagonalCosts.at(zoneTile.zoneID);
+    pushDiagonalIfEmpty(x, y, -1, -1, zoneTile.zoneID, cost, diagonalCost);
+    pushDiagonalIfEmpty(x, y, 1, -1, zoneTile.zoneID, cost, diagonalCost);
+    pushDiagonalIfEmpty(x, y, 1, 1, zoneTile.zoneID, cost, diagonalCost);
+    pushDiagonalIfEmpty(x, y, -1, 1, zoneTile.zoneID, cost, diagonalCost);
+}
+
+// A diagonal move doesn't squeeze between two tiles of a wall
+template <typename T>
+void PriorityZoneBloater<T>::pushDiagonalIfEmpty(int x, int y, int dx, int dy, Identifiable zone, long long cost, long long moveCost){
+    if (!tileWeights.empty() && grid->isValidPoint({x + dx, y + dy}) && (isImpassable(x + dx, y) || isImpassable(x, y + dy))){
+        return;
+    }
+    pushIfEmpty(x + dx, y + dy, zone, cost, moveCost);
+}
+
+template <typename T>
+bool PriorityZoneBloater<T>::isImpassable(int x, int y) const{
+    return tileWeights[y * costFieldWidth + x] == 0;
+}
+
+template <typename T>
+void PriorityZoneBloater<T>::pushIfEmpty(int x, int y, Identifiable zone, long long cost, long long moveCost){
+    if (!grid->isValidPoint({x, y}) || !grid->isEmpty(x, y)){
+        return;
+    }
+    if (tileWeights.empty()){
+        queue.emplace(cost + moveCost, x, y, zone);
+        return;
+    }
+    if (isImpassable(x, y)){
+        return;
+    }
+    float weight = tileWeights[y * costFieldWidth + x];
+    queue.emplace(cost + std::max(1LL, std::llround(moveCost * static_cast<double>(weight))), x, y, zone);
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+#include "grid.h"
+#include "matrix.h"
+#include "identifiable.h"
+
+// Resolution pyramids: level 0 is the original, each next level is `factor` times smaller per axis.
+// Downsampled sizes are rounded up, so border blocks may cover less than factor x factor cells.
+namespace pyramid{
+
+    int downsampledSize(int size, int factor);
+
+    // Arithmetic values are averaged over each block, bool values are OR-ed.
+    template <typename T>
+    Matrix<T> downsample(const Matrix<T>& matrix, int factor);
+
+    // Nearest neighbour, width and height are the dimension of the finer level.
+    template <typename T>
+    Matrix<T> upsample(const Matrix<T>& matrix, int factor, int width, int height);
+
+    // Each block takes its most frequent non-null ID, ties go to the smaller ID. The tileset is kept.
+    template <typename T>
+    Grid<T> downsample(const Grid<T>& grid, int factor);
+
+    template <typename T>
+    Grid<T> upsample(const Grid<T>& grid, int factor, int width, int height);
+
+    template <typename T>
+    std::vector<Matrix<T>> buildPyramid(const Matrix<T>& base, int levels, int factor = 2);
+
+    template <typename T>
+    std::vector<Grid<T>> buildPyramid(const Grid<T>& base, int levels, int factor = 2);
+
+    template <typename T>
+    std::vector<T> getTileset(const Grid<T>& grid);
+
+
+    inline int downsampledSize(int size, int factor){
+        if (factor < 1){
+            throw std::invalid_argument("pyramid: factor must be positive");
+        }
+        return (size + factor - 1) / factor;
+    }
+
+    template <typename T>
+    Matrix<T> downsample(const Matrix<T>& matrix, int factor){
+        int width = downsampledSize(matrix.getWidth(), factor);
+        int height = downsampledSize(matrix.getHeight(), factor);
+        Matrix<T> result(width, height);
+        for (int cy = 0; cy < height; cy++){
+            for (int cx = 0; cx < width; cx++){
+                int endX = std::min(matrix.getWidth(), (cx + 1) * factor);
+                int endY = std::min(matrix.getHeight(), (cy + 1) * factor);
+                if constexpr (std::same_as<T, bool>){
+                    bool any = false;
+                    for (int y = cy * factor; y < endY && !any; y++){
+                        for (int x = cx * factor; x < endX && !any; x++){
+                            any = matrix.get(x, y);
+                        }
+                    }
+                    result.set(cx, cy, any);
+                } else{
+                    static_assert(std::is_arithmetic_v<T>, "T must be arithmetic or bool");
+                    double sum = 0;
+                    int count = 0;
+                    for (int y = cy * factor; y < endY; y++){
+                        for (int x = cx * factor; x < endX; x++){
+                            sum += matrix.get(x, y);
+                            count++;
+                        }
+                    }
+                    result.set(cx, cy, static_cast<T>(sum / count));
+                }
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+    Matrix<T> upsample(const Matrix<T>& matrix, int factor, int width, int height){
+        if (downsampledSize(width, factor) != matrix.getWidth() || downsampledSize(height, factor) != matrix.getHeight()){
+            throw std::invalid_argument("pyramid::upsample: dimension doesn't match the factor");
+        }
+        Matrix<T> result(width, height);
+        for (int y = 0; y < height; y++){
+            for (int x = 0; x < width; x++){
+                result.set(x, y, matrix.get(x / factor, y / factor));
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+    Grid<T> downsample(const Grid<T>& grid, int factor){
+        int width = downsampledSize(grid.getWidth(), factor);
+        int height = downsampledSize(grid.getHeight(), factor);
+        Grid<T> result(width, height, getTileset(grid));
+        std::vector<std::pair<Identifiable, int>> counts;
+        for (int cy = 0; cy < height; cy++){
+            for (int cx = 0; cx < width; cx++){
+                counts.clear();
+                int endX = std::min(grid.getWidth(), (cx + 1) * factor);
+                int endY = std::min(grid.getHeight(), (cy + 1) * factor);
+                for (int y = cy * factor; y < endY; y++){
+                    for (int x = cx * factor; x < endX; x++){
+                        Identifiable id = grid.getTileID(x, y);
+                        if (id == Identifiable::nullID){
+                            continue;
+                        }
+                        auto it = std::find_if(counts.begin(), counts.end(), [id](const auto& count){
+                            return count.first == id;
+                        });
+                        if (it == counts.end()){
+                            counts.emplace_back(id, 1);
+                        } else{
+                            it->second++;
+                        }
+                    }
+                }
+                if (counts.empty()){
+                    continue;
+                }
+                auto best = std::min_element(counts.begin(), counts.end(), [](const auto& a, const auto& b){
+                    return a.second > b.second || (a.second == b.second && a.first < b.first);
+                });
+                result.setTile(cx, cy, best->first);
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+    Grid<T> upsample(const Grid<T>& grid, int factor, int width, int height){
+        if (downsampledSize(width, factor) != grid.getWidth() || downsampledSize(height, factor) != grid.getHeight()){
+            throw std::invalid_argument("pyramid::upsample: dimension doesn't match the factor");
+        }
+        Grid<T> result(width, height, getTileset(grid));
+        for (int y = 0; y < height; y++){
+            for (int x = 0; x < width; x++){
+                result.setTile(x, y, grid.getTileID(x / factor, y / factor));
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+    std::vector<Matrix<T>> buildPyramid(const Matrix<T>& base, int levels, int factor){
+        std::vector<Matrix<T>> result;
+        result.reserve(levels);
+        result.push_back(base);
+        for (int level = 1; level < levels; level++){
+            result.push_back(downsample(result.back(), factor));
+        }
+        return result;
+    }
+
+    template <typename T>
+    std::vector<Grid<T>> buildPyramid(const Grid<T>& base, int levels, int factor){
+        std::vector<Grid<T>> result;
+        result.reserve(levels);
+        result.push_back(base);
+        for (int level = 1; level < levels; level++){
+            result.push_back(downsample(result.back(), factor));
+        }
+        return result;
+    }
+
+    template <typename T>
+    std::vector<T> getTileset(const Grid<T>& grid){
+        std::vector<T> tileset;
+        tileset.reserve(grid.getTileIDs().size());
+        for (Identifiable id : grid.getTileIDs()){
+            tileset.push_back(grid.getTile(id));
+        }
+        return tileset;
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <random>
+#include <cstdint>
 
 class RandomGenerator{
     public:
@@ -16,6 +17,10 @@ class RandomGenerator{
         void reset();
         unsigned int getSeed() const;
         unsigned int generateSeed();
+
+        // Stateless counter-based random, the same arguments always give the same hash (SplitMix64 mixing).
+        static uint64_t counterHash(uint64_t seed, int x, int y, int zone, long long step, int stream = 0);
+        static bool counterChanceOccurred(double probability, uint64_t hash);
     private:
         unsigned int seed;
         std::mt19937 generator;
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "bucket_queue.h"
+
+// Nearest seed of every cell, ties going to the seed with the lower cell index (y * width + x).
+// Adding or removing a seed only visits the cells whose nearest seed changes and their border,
+// candidates are spread outwards from the seeds in the order of their distance.
+class SeedField{
+    public:
+        enum class Metric{
+            manhattan, // 4 neighbours
+            chebyshev  // 8 neighbours
+        };
+        static constexpr int noSeed = -1;
+
+        SeedField() = default;
+        SeedField(int width, int height, Metric metric);
+
+        // Every call appends the cells whose nearest seed changed to changed, in the order they change,
+        // so a seed cell always comes before the cells it takes. A cell may come more than once.
+        void addSeeds(const std::vector<int>& seeds, std::vector<int>& changed);
+        void addSeed(int seed, std::vector<int>& changed);
+        void removeSeed(int seed, std::vector<int>& changed);
+
+        bool isSeed(int cell) const{return nearest[cell] == cell;};
+        int getNearest(int cell) const{return nearest[cell];};
+        int getWidth() const{return width;};
+        int getHeight() const{return height;};
+        bool isEmpty() const{return nearest.empty();};
+
+    private:
+        struct Candidate{
+            int cell;
+            int seed;
+        };
+
+        long long distance(int cell, int seed) const;
+        bool improves(int cell, int seed) const;
+        void checkCell(int cell) const;
+        template <typename Visitor>
+        void forNeighbours(int cell, Visitor&& visitor) const;
+        void spread(std::vector<int>& changed);
+
+        int width = 0;
+        int height = 0;
+        Metric metric = Metric::manhattan;
+        std::vector<int> nearest;
+
+        BucketQueue<Candidate> queue;
+        std::vector<Candidate> bucket;
+        std::vector<int> region;
+};
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <chrono>
+
+#include "simulator_observer.h"
+
+class StepRecorder;
+
 enum class SimulationStatus{
     INIT,
     RUNNING,
@@ -8,6 +14,8 @@ enum class SimulationStatus{
 
 class Simulator{
     public:
+        using Clock = std::chrono::steady_clock;
+
         Simulator(){};
         virtual ~Simulator() = default;
 
@@ -21,6 +29,14 @@ class Simulator{
         virtual bool step() final;
         virtual void finish() final;
         virtual void reset() final;
+        // Starts if needed and runs to FINISHED with the same result as stepping, without the per-step checks.
+        virtual void runToCompletion() final;
+        // Steps until the deadline passes or the simulation finishes and returns isRunning() like step().
+        // Some work is done on every call. Simulators overriding onStepUntil may stop partway through a step
+        // and resume it on the next call, so a call overshoots the deadline by one slice of a step at most.
+        virtual bool stepUntil(Clock::time_point deadline) final;
+        template <typename Rep, typename Period>
+        bool stepFor(std::chrono::duration<Rep, Period> budget){return stepUntil(Clock::now() + std::chrono::duration_cast<Clock::duration>(budget));};
 
         bool isInitialized() const{return status == SimulationStatus::INIT;};
         bool isRunning() const{return status == SimulationStatus::RUNNING;};
@@ -29,6 +45,14 @@ class Simulator{
         long long getStep() const;
         SimulationStatus getStatus() const;
 
+        // Records the cells changed by each step into recorder, nullptr detaches it. Only in INIT status, and the
+        // recorder must outlive the simulation. Simulators not supporting it finish and throw from start, before any step.
+        void setRecorder(StepRecorder* recorder);
+        StepRecorder* getRecorder() const{return recorder;};
+        // Reports every step to observer, nullptr detaches it. Without one a step only checks the pointer.
+        void setObserver(SimulatorObserver* observer);
+        SimulatorObserver* getObserver() const;
+
         static constexpr long long STARTING_STEP = 0;
         static constexpr long long NOT_STARTED_STEP = -1;
 
@@ -37,7 +61,25 @@ class Simulator{
         virtual void onStep() = 0;
         virtual void onFinish(){};
         virtual void onReset(){};
+        // Runs the rest of the simulation and finishes it, steps one by one unless overridden.
+        virtual void onRun();
+        // Steps one by one until the deadline passes unless overridden. Overrides count the finished
+        // steps with addSteps, and a step left partway must be completed by the next onStep.
+        virtual void onStepUntil(Clock::time_point deadline);
+        // Lets onRun overrides keep getStep() equal to the number of steps the simulation would take.
+        // Ends count recorded and observed steps too, so overrides add the steps one by one to keep them apart.
+        void addSteps(long long count);
+        // onRun and onStepUntil overrides call it before running or resuming the work of a step.
+        void beginStep(){if (observer) observation.begin(*observer, steps + 1, getChangedCells(), getFrontierSize());};
+        // Running total of the tiles changed and the current frontier, reported to the observer. 0 unless overridden.
+        virtual long long getChangedCells() const{return 0;};
+        virtual long long getFrontierSize() const{return 0;};
     private:
+        void runStep();
+
         long long steps = NOT_STARTED_STEP;
         SimulationStatus status = SimulationStatus::INIT;
+        StepRecorder* recorder = nullptr;
+        SimulatorObserver* observer = nullptr;
+        StepObservation observation;
 };
\ No newline at end of file
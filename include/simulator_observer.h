@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+
+struct StepProfile{
+    long long step;
+    // Tiles changed by the step (spots moved for EmbeddablePlane) and the frontier left after it,
+    // 0 for simulators which don't track them
+    long long cellsChanged;
+    long long frontierSize;
+    // Time spent in the step, without the time between the calls a step split by a deadline ran in
+    long long elapsedNanoseconds;
+};
+
+// Per-step profiling hook, see Simulator::setObserver and EmbeddablePlane::setObserver.
+// Called on the stepping thread, a step split by a deadline is begun once and ended once.
+class SimulatorObserver{
+    public:
+        virtual ~SimulatorObserver() = default;
+        // frontierSize is the frontier the step bloats
+        virtual void onStepBegin(long long /*step*/, long long /*frontierSize*/){};
+        virtual void onStepEnd(const StepProfile& /*profile*/){};
+};
+
+// Bookkeeping of the step an observer is being told about, kept by the observed class.
+class StepObservation{
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // Starts timing from now, for the first step when begin isn't called.
+        void reset(long long changedCells);
+        // Begins the step, or resumes timing it when it was begun and paused.
+        void begin(SimulatorObserver& observer, long long step, long long changedCells, long long frontierSize);
+        void pause();
+        // Ends the step, changedCells is the running total the cells changed by the step are taken from.
+        void end(SimulatorObserver& observer, long long step, long long changedCells, long long frontierSize);
+
+    private:
+        bool begun = false;
+        bool paused = false;
+        long long startCells = 0;
+        Clock::duration elapsed{};
+        Clock::time_point segmentStart = Clock::now();
+};
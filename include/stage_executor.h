@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <future>
+#include <stop_token>
+#include <chrono>
+#include <stdexcept>
+
+#include "generator.h"
+#include "stage_progress.h"
+
+enum class StageResult{
+    completed,
+    cancelled
+};
+
+// Handle of a submitted stage. get() waits for the stage and rethrows what the stage or its progress callback threw.
+// Once get() or wait() returned, the worker has dropped the stage, so the objects it worked on may be destroyed.
+class StageHandle{
+    public:
+        StageHandle() = default;
+
+        // Asks the stage to stop, it is checked before every resume. A stage which was not started yet is never started.
+        void cancel();
+        bool isCancelRequested() const;
+        std::stop_token getStopToken() const;
+
+        bool valid() const;
+        void wait() const;
+        template <typename Rep, typename Period>
+        std::future_status waitFor(const std::chrono::duration<Rep, Period>& timeout) const;
+        StageResult get();
+
+    private:
+        friend class StageExecutor;
+        StageHandle(std::future<StageResult> future, std::stop_source stopSource) :
+            future(std::move(future)), stopSource(std::move(stopSource)){};
+
+        std::future<StageResult> future;
+        std::stop_source stopSource;
+};
+
+// Runs stage generators (stages.h) on its own worker threads, so a generation can be started from a request thread
+// and cancelled when nobody waits for it anymore. Cancellation is cooperative: a stage stops at its next yield,
+// so it takes one embedding iteration, simulation step or blend batch.
+// Stages may still use ThreadPool::instance() for their parallel parts.
+class StageExecutor{
+    public:
+        using ProgressCallback = std::function<void(const StageProgress&)>;
+
+        explicit StageExecutor(size_t threadCount = 1);
+        // Cancels the queued and running stages and waits for the workers.
+        ~StageExecutor();
+
+        StageExecutor(const StageExecutor&) = delete;
+        StageExecutor& operator=(const StageExecutor&) = delete;
+
+        // The stage runs on a worker, which also calls onProgress after every yield. The stage is lazy,
+        // so even its setup runs on the worker. The objects the stage works on must outlive it.
+        StageHandle submit(Generator<StageProgress> stage, ProgressCallback onProgress = {});
+
+        size_t size() const;
+
+    private:
+        struct Job{
+            Generator<StageProgress> stage;
+            ProgressCallback onProgress;
+            std::promise<StageResult> promise;
+            std::stop_token stopToken;
+        };
+
+        void workerLoop();
+        void run(Job& job);
+
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::deque<Job> queue;
+        std::atomic<bool> stopping = false;
+};
+
+template <typename Rep, typename Period>
+std::future_status StageHandle::waitFor(const std::chrono::duration<Rep, Period>& timeout) const{
+    if (!future.valid()){
+        throw std::logic_error("Stage handle has no result");
+    }
+    return future.wait_for(timeout);
+}
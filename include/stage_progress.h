@@ -0,0 +1,20 @@
+#pragma once
+
+enum class StagePhase{
+    embed,
+    simulate,
+    borders,
+    passes,
+    blendIntake,
+    blendGuarantor,
+    blendSpread,
+    blendNormalize,
+    resources
+};
+
+// Yielded by the stage generators: the phase a stage is in and the steps done in that phase
+// (embedding iterations, simulation steps, traced borders, borders given passes, processed queue elements, normalized rows or generated resources).
+struct StageProgress{
+    StagePhase phase;
+    long long step;
+};
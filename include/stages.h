@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#include "generator.h"
+#include "stage_progress.h"
+#include "simulator.h"
+#include "embedding.h"
+#include "graph.h"
+#include "resource_generator.h"
+#include "matrix.h"
+#include "border.h"
+#include "edge_graph.h"
+#include "connection_table.h"
+
+// Generation stages as lazy generators. Each resume runs one step of the stage, so a frame can resume a stage
+// as long as its budget lasts and dropping the generator cancels it. The objects a stage works on must
+// outlive it. blendConnectionsStaged, blendConnectionsSparseStaged (blender.h) and tiles::Border::traceAllBorders
+// are stages as well.
+namespace stages{
+
+    // Embeds graph into plane, one yield per force-directed iteration.
+    template <typename T>
+    Generator<StageProgress> embed(EmbeddablePlane<T>& plane, std::shared_ptr<const Graph<T>> graph);
+
+    // Starts simulator if it is INIT and steps it to FINISHED, one yield per step.
+    // Simulator::step is final, so the only virtual call of a step is the simulator's own onStep.
+    Generator<StageProgress> simulate(Simulator& simulator);
+
+    // Runs the stages one after another. They are created up front but start only when reached, so a stage
+    // may work on objects an earlier stage fills, e.g. a bloater which an earlier stage initializes.
+    Generator<StageProgress> chain(std::vector<Generator<StageProgress>> stages);
+
+    // ResourceGenerator::generateResources into result, one yield per resource.
+    template <typename T>
+    Generator<StageProgress> resources(ResourceGenerator<T>& generator, std::vector<Matrix<bool>>& result);
+
+    // Generates the walls and passes of every border (Border::initPassData and generatePasses) with the pass parameters
+    // of the sym edge between its zones, one yield per border. Borders of zones without a sym edge are left as they are.
+    template <typename NodeT, typename SymEdgeT, typename AsymEdgeT>
+    Generator<StageProgress> passes(
+            std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<tiles::Border>, PairIDHash>& borders,
+            const EdgeGraph<NodeT, SymEdgeT, AsymEdgeT>& mapTemplate
+        );
+
+    template <typename T>
+    Generator<StageProgress> embed(EmbeddablePlane<T>& plane, std::shared_ptr<const Graph<T>> graph){
+        plane.initEmbed(graph);
+        long long iteration = 0;
+        while (plane.stepForceDirected()){
+            co_yield StageProgress{StagePhase::embed, ++iteration};
+        }
+    }
+
+    template <typename T>
+    Generator<StageProgress> resources(ResourceGenerator<T>& generator, std::vector<Matrix<bool>>& result){
+        size_t count = generator.getResourceThresholds().size();
+        result.clear();
+        result.reserve(count);
+        for (size_t i = 0; i < count; i++){
+            result.push_back(generator.generateResource(i));
+            co_yield StageProgress{StagePhase::resources, static_cast<long long>(i + 1)};
+        }
+    }
+
+    template <typename NodeT, typename SymEdgeT, typename AsymEdgeT>
+    Generator<StageProgress> passes(
+            std::unordered_map<std::pair<Identifiable, Identifiable>, std::vector<tiles::Border>, PairIDHash>& borders,
+            const EdgeGraph<NodeT, SymEdgeT, AsymEdgeT>& mapTemplate
+        ){
+        static_assert(std::is_base_of_v<tiles::PassParams, SymEdgeT>, "Sym edges must hold tiles::PassParams");
+        ConnectionTable<SymEdgeT, AsymEdgeT> connections(mapTemplate);
+        long long done = 0;
+        for (auto& [zones, zoneBorders] : borders){
+            const SymEdgeT* connection = connections.findSym(zones.first, zones.second);
+            for (tiles::Border& border : zoneBorders){
+                if (connection && border.size() > 0){
+                    border.initPassData(static_cast<const tiles::PassParams&>(*connection));
+                    border.generatePasses();
+                }
+                co_yield StageProgress{StagePhase::passes, ++done};
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <functional>
+
+#include "grid.h"
+#include "identifiable.h"
+
+// Cell history of a simulation over a grid. A step is stored as the cells it changed, each one as the varint
+// encoded difference of its index and value from the cell before it, a couple of bytes per cell.
+// A run-length encoded keyframe of the whole frame is added once the changes since the last one reach
+// keyframeSpacing times the cell count, so seeking any step decodes one keyframe and replays less than that.
+// Attach it with Simulator::setRecorder, simulators supporting it call begin from onStart and record on writes.
+// No copy of the frame is kept, keyframes read the simulation state through the cell reader given to begin.
+class StepRecorder{
+    public:
+        explicit StepRecorder(double keyframeSpacing = 0.25);
+
+        // Starts a new history from the current frame (step 0), dropping the old one. readCell returns the current
+        // value of a cell (y * width + x) and is called from begin and endSteps, the grid overload reads the grid.
+        void begin(int width, int height, std::function<int(int)> readCell);
+        template <typename T>
+        void begin(const Grid<T>& grid);
+        // Drops the history, Simulator::start calls it before onStart.
+        void clear();
+        // The cell has the value from now on.
+        void record(int cell, int value);
+        // Ends count steps, the cells recorded since the last step end go to the first of them.
+        void endSteps(long long count = 1);
+
+        bool isStarted() const;
+        // Steps ended since begin
+        long long getStepCount() const;
+        int getWidth() const;
+        int getHeight() const;
+        size_t getByteSize() const;
+
+        // Cell values after step (0 is the initial frame).
+        void seek(long long step, std::vector<int>& cells) const;
+        template <typename T>
+        void seek(long long step, Grid<T>& grid) const;
+        // Applies step to the frame after step - 1, for playing the history forwards.
+        void applyStep(long long step, std::vector<int>& cells) const;
+
+    private:
+        struct Keyframe{
+            long long step;
+            std::vector<uint8_t> runs;
+        };
+
+        static uint64_t zigzag(long long value){return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);};
+        static long long unzigzag(uint64_t value){return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);};
+        static void writeVarint(std::vector<uint8_t>& bytes, uint64_t value);
+        static uint64_t readVarint(const std::vector<uint8_t>& bytes, size_t& position);
+
+        void addKeyframe();
+        void checkStep(long long step) const;
+
+        double keyframeSpacing;
+        int width = 0;
+        int height = 0;
+        std::function<int(int)> readCell;
+        std::vector<uint8_t> deltas;
+        // Offset of the first byte of each step in deltas, the last one is the end of the recorded steps
+        std::vector<size_t> stepOffsets;
+        std::vector<Keyframe> keyframes;
+        int lastCell = 0;
+        int lastValue = 0;
+        size_t changesSinceKeyframe = 0;
+};
+
+inline void StepRecorder::writeVarint(std::vector<uint8_t>& bytes, uint64_t value){
+    while (value >= 0x80){
+        bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+inline void StepRecorder::record(int cell, int value){
+    changesSinceKeyframe++;
+    writeVarint(deltas, zigzag(static_cast<long long>(cell) - lastCell));
+    writeVarint(deltas, zigzag(static_cast<long long>(value) - lastValue));
+    lastCell = cell;
+    lastValue = value;
+}
+
+template <typename T>
+void StepRecorder::begin(const Grid<T>& grid){
+    int width = grid.getWidth();
+    begin(width, grid.getHeight(), [&grid, width](int cell){
+        return grid.getTileID(cell % width, cell / width).getID();
+    });
+}
+
+template <typename T>
+void StepRecorder::seek(long long step, Grid<T>& grid) const{
+    if (grid.getWidth() != width || grid.getHeight() != height){
+        throw std::invalid_argument("StepRecorder::seek: grid size differs from the recorded one");
+    }
+    std::vector<int> cells;
+    seek(step, cells);
+    for (int y = 0; y < height; y++){
+        for (int x = 0; x < width; x++){
+            Identifiable id = cells[static_cast<size_t>(y) * width + x];
+            if (grid.getTileID(x, y) != id){
+                grid.setTile(x, y, id);
+            }
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <exception>
+
+class ThreadPool{
+    public:
+        // (chunk index, first index, past-the-end index)
+        using ChunkTask = std::function<void(size_t, size_t, size_t)>;
+
+        explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        static ThreadPool& instance();
+
+        // Number of threads taking part in parallelFor, including the calling thread.
+        size_t size() const;
+
+        // Splits [0, count) into getChunkCount(count) contiguous chunks and blocks until all of them are processed.
+        // Chunk boundaries depend only on count and size(), so per-chunk results can be merged in chunk order.
+        void parallelFor(size_t count, const ChunkTask& task);
+        size_t getChunkCount(size_t count) const;
+
+        static size_t chunkBegin(size_t count, size_t chunks, size_t chunk);
+
+    private:
+        void workerLoop();
+        void runChunks();
+
+        std::vector<std::thread> workers;
+
+        std::mutex submitMutex;
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::condition_variable done;
+
+        const ChunkTask* task = nullptr;
+        size_t count = 0;
+        size_t chunkCount = 0;
+        std::atomic<size_t> nextChunk = 0;
+        std::atomic<size_t> finishedChunks = 0;
+        size_t activeWorkers = 0;
+        size_t generation = 0;
+        bool stopping = false;
+        std::exception_ptr failure;
+};
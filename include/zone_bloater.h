@@ -1,12 +1,19 @@
 #pragma once
 
 #include <memory>
-#include <queue>
+#include <vector>
+#include <atomic>
+#include <limits>
+#include <typeinfo>
+#include <optional>
+#include <unordered_map>
+#include <algorithm>
 
 #include "self_pointer.h"
 
 #include "identifiable.h"
 #include "grid.h"
+#include "id_map.h"
 #include "edge_graph.h"
 #include "simulator.h"
 #include "2d.h"
@@ -15,49 +22,156 @@
 #include "radial.h"
 #include "line.h"
 #include "bloat_strategy.h"
+#include "pyramid.h"
+#include "thread_pool.h"
+#include "frontier_filter.h"
+#include "seed_field.h"
+#include "step_recorder.h"
 
-template<typename T, typename SymEdgeT, typename AsymEdgeT>
+// With Policy = bloatPolicies::Dynamic tiles are bloated by the BloatStrategy set by setBloatMode.
+// Any other Policy (see bloat_policy.h) is fixed at compile time and works on the grid and frontier directly.
+template<typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy = bloatPolicies::Dynamic>
 class ZoneBloater : public Simulator, public ZoneTilePusher{
     public:
         //Empty grid tiles are considered NullID
         void initEdgeVoronoi(const EdgeGraph<T, SymEdgeT, AsymEdgeT>& graph, std::shared_ptr<Grid<T>> initialGrid);
         void initVoronoi(std::shared_ptr<Grid<T>> initialGrid);
+        // The first step scans the empty tiles in raster order, later steps only visit the empty
+        // neighbours of the tiles filled by the step before.
         void initAdjacentCornerFill(std::shared_ptr<Grid<T>> grid);
+        // Bloats a grid downsampled by factor to completion with the current bloat mode, upsamples it and
+        // leaves only the cells within refineBand coarse cells of a zone border (or of a seed) to be bloated by stepping.
+        // A block can keep only one zone, so factor is halved until no block holds seeds of two zones, and
+        // below 2 it is a plain initVoronoi.
+        void initCoarseToFineVoronoi(std::shared_ptr<Grid<T>> initialGrid, int factor, int refineBand = 1);
         virtual void onStart() override;
         virtual void onStep() override;
+        // Stops partway through a layer when the deadline passes, the next step or onStepUntil call
+        // bloats the rest of it. Parallel steps are not split.
+        void onStepUntil(Clock::time_point deadline) override;
         void onReset() override;
         void finishAndReset();
+        // Same grid as stepping. Runs layers back to back without the frontier size check, and a dynamic
+        // strategy with a matching bloatPolicies policy is run through it statically.
+        void onRun() override;
 
         std::shared_ptr<Grid<T>> getGrid() const;
 
         template <typename Strategy>
-        requires std::is_base_of_v<BloatStrategy, std::decay_t<Strategy>>
+        requires (std::is_base_of_v<BloatStrategy, std::decay_t<Strategy>> && !bloatPolicies::isStatic<Policy>)
         void setBloatMode(Strategy&& bloatStrategy);
 
+        // Replaces the default constructed policy, for example to change its chances.
+        void setBloatPolicy(const Policy& policy) requires bloatPolicies::isStatic<Policy>;
+
+        // Steps with at least minParallelStepSize expanders are split over the pool. A cell claimed by several
+        // expanders goes to the first of them in frontier order, so the grid is the same as the serial one
+        // for any thread count. Grid writes stay on the calling thread to keep the zone statistics valid.
+        void enableParallelStep(ThreadPool& pool = ThreadPool::instance()) requires bloatPolicies::isParallelSafe<Policy>;
+        void disableParallelStep();
+        static constexpr int minParallelStepSize = 4096;
+
+        // Frontier pushes since init before and after the redundant ones are dropped (see FrontierFilter).
+        long long getAttemptedPushes() const;
+        long long getAcceptedPushes() const;
+
+        // Seed edits after a finished initVoronoi bloat with StraightBloat or ChebyshevBloat. Such a bloat gives
+        // every tile the zone of its nearest seed by Manhattan (Chebyshev) distance, ties going to the seed
+        // first in raster order, so only the tiles whose nearest seed changes are updated and the grid stays
+        // the same as a full rebuild with the new seeds. The first edit builds the seed field in O(grid size).
+        void addSeed(IntVector2 point, Identifiable zoneID);
+        void removeSeed(IntVector2 point);
+        void moveSeed(IntVector2 from, IntVector2 to);
+
     protected:
         void push(const ZoneTile& zoneTile) override;
         void setZoneTile(const ZoneTile& zoneTile) override;
         bool isEmpty(IntVector2 point) const override;
         bool isValidPoint(IntVector2 point) const override;
         std::optional<Identifiable> tryGetID(IntVector2 point) const override;
+        long long getBloatStep() const override;
+        long long getChangedCells() const override;
+        // The frontier of the next layer, or of the current one while it is bloated partway
+        long long getFrontierSize() const override;
     private:
 
         std::shared_ptr<Grid<T>> grid;
         
-        std::queue<std::shared_ptr<ZoneTile>> nextExpanders;
+        // Double-buffered frontier: a step bloats currentExpanders while pushes go to nextExpanders.
+        // Both keep their capacity across steps and resets.
+        std::vector<ZoneTile> currentExpanders;
+        std::vector<ZoneTile> nextExpanders;
         int max_expanders = 0;
         int currentStepSize = 0;
+        FrontierFilter frontierFilter;
+        // Layers bloated since init, the step the hashed policies draw with
+        long long bloatStep = 0;
+        // The next layer is every empty tile in raster order, visited without building the frontier
+        bool scanPending = false;
+        // Frontier index (tile index for a scan) to resume the current layer from, 0 between layers
+        size_t layerPosition = 0;
+        static constexpr size_t deadlineCheckInterval = 256;
+
+        // Seeds of the last initVoronoi, the seed field is built from them on the first seed edit
+        std::optional<std::vector<ZoneTile>> voronoiSeeds;
+        SeedField seedField;
+        std::vector<int> changedCells;
 
         std::unique_ptr<BloatStrategy> bloatStrategy;
+        [[no_unique_address]] Policy policy;
+
+        static constexpr uint32_t unclaimed = std::numeric_limits<uint32_t>::max();
+        ThreadPool* pool = nullptr;
+        // Lowest frontier index claiming each cell during a parallel step, unclaimed between steps.
+        std::vector<std::atomic<uint32_t>> claims;
+        std::vector<std::vector<ZoneTile>> chunkWinners;
+        std::vector<std::vector<ZoneTile>> chunkFrontiers;
+
+        // Hides the tile from the expanders after the one which claimed it, as if that one had already set it.
+        struct ClaimPusher{
+            const Grid<T>& grid;
+            const std::vector<std::atomic<uint32_t>>& claims;
+            std::vector<ZoneTile>& winners;
+            std::vector<ZoneTile>& frontier;
+            uint32_t index;
+            long long step;
+
+            void push(const ZoneTile& zoneTile){frontier.push_back(zoneTile);}
+            void setZoneTile(const ZoneTile& zoneTile){winners.push_back(zoneTile);}
+            bool isEmpty(IntVector2 point) const{return grid.getTileID(point) == Identifiable::nullID && claims[point.y * grid.getWidth() + point.x].load(std::memory_order_relaxed) >= index;}
+            bool isValidPoint(IntVector2 point) const{return grid.isValidPoint(point);}
+            long long getBloatStep() const{return step;}
+        };
+        void parallelStep();
+
+        void beginLayer();
+        void endLayer();
+        // Bloat the rest of the current layer, with a deadline they return false if it passed first.
+        bool bloatLayer(std::optional<Clock::time_point> deadline = std::nullopt);
+        template <typename StaticPolicy>
+        bool bloatLayer(const StaticPolicy& staticPolicy, std::optional<Clock::time_point> deadline = std::nullopt);
+        template <typename LayerBloater>
+        void runLayers(LayerBloater&& layerBloater);
+        template <typename TileBloater>
+        bool bloatRest(TileBloater&& tileBloater, std::optional<Clock::time_point> deadline);
+
+        SeedField::Metric getSeedMetric() const;
+        void prepareSeedField();
+        int toSeedCell(IntVector2 point) const;
+        void applySeedChanges();
+        // Whether seeds of different zones fall into the same factor x factor block
+        static bool hasSharedBlock(const std::vector<ZoneTile>& seeds, int width, int factor);
 
     private:
-        void setEdgeExpanders(const std::unordered_map<Identifiable, IntVector2, IDHash>& startingPoints, const EdgeGraph<T, SymEdgeT, AsymEdgeT>& graph);
+        void setEdgeExpanders(const IDMap<IntVector2>& startingPoints, const EdgeGraph<T, SymEdgeT, AsymEdgeT>& graph);
 };
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-void ZoneBloater<T, SymEdgeT, AsymEdgeT>::initEdgeVoronoi(const EdgeGraph<T, SymEdgeT, AsymEdgeT>& graph, std::shared_ptr<Grid<T>> initialGrid){
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::initEdgeVoronoi(const EdgeGraph<T, SymEdgeT, AsymEdgeT>& graph, std::shared_ptr<Grid<T>> initialGrid){
     grid = initialGrid;
-    std::unordered_map<Identifiable, IntVector2, IDHash> startingPoints;
+    frontierFilter = FrontierFilter(grid->getWidth(), grid->getHeight());
+    voronoiSeeds.reset();
+    IDMap<IntVector2> startingPoints;
     for (auto it = grid->begin(); it != grid->end(); ++it){
         if (*it != Identifiable::nullID){
             startingPoints[*it] = {it.getX(), it.getY()};
@@ -68,107 +182,559 @@ void ZoneBloater<T, SymEdgeT, AsymEdgeT>::initEdgeVoronoi(const EdgeGraph<T, Sym
     max_expanders = 8 * grid->getWidth() * grid->getHeight();
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-void ZoneBloater<T, SymEdgeT, AsymEdgeT>::initVoronoi(std::shared_ptr<Grid<T>> initialGrid){
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::initVoronoi(std::shared_ptr<Grid<T>> initialGrid){
     grid = initialGrid;
+    frontierFilter = FrontierFilter(grid->getWidth(), grid->getHeight());
     for (auto it = grid->begin(); it != grid->end(); ++it){
         if (*it != Identifiable::nullID){
+            nextExpanders.emplace_back(it.getX(), it.getY(), *it);
             grid->setTile(it.getX(), it.getY(), Identifiable::nullID);
-            nextExpanders.push(std::make_shared<ZoneTile>(ZoneTile(it.getX(), it.getY(), *it)));
         }
     }
+    voronoiSeeds = nextExpanders;
+    seedField = SeedField();
     max_expanders = 8 * grid->getWidth() * grid->getHeight();
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-void ZoneBloater<T, SymEdgeT, AsymEdgeT>::initAdjacentCornerFill(std::shared_ptr<Grid<T>> grid){
-    setBloatMode(bloatStrategies::AdjacentCornerFill());
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::initAdjacentCornerFill(std::shared_ptr<Grid<T>> grid){
+    if constexpr (bloatPolicies::isStatic<Policy>){
+        static_assert(std::same_as<Policy, bloatPolicies::AdjacentCornerFill>, "Static policy must be AdjacentCornerFill");
+    } else{
+        setBloatMode(bloatStrategies::AdjacentCornerFill());
+    }
     this->grid = grid;
-    for (auto it = grid->begin(); it != grid->end(); ++it){
-        if (*it == Identifiable::nullID){
-            nextExpanders.push(std::make_shared<ZoneTile>(it.getX(), it.getY(), Identifiable::nullID));
+    frontierFilter = FrontierFilter(grid->getWidth(), grid->getHeight());
+    voronoiSeeds.reset();
+    scanPending = true;
+    max_expanders = 4 * grid->getWidth() * grid->getHeight();
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::initCoarseToFineVoronoi(std::shared_ptr<Grid<T>> initialGrid, int factor, int refineBand){
+    if (!bloatPolicies::isStatic<Policy> && !bloatStrategy)
+        throw std::logic_error("Bloat mode must be set before coarse-to-fine init");
+    std::vector<ZoneTile> seeds;
+    for (auto it = initialGrid->begin(); it != initialGrid->end(); ++it){
+        if (*it != Identifiable::nullID){
+            seeds.push_back(ZoneTile(it.getX(), it.getY(), *it));
         }
     }
-    max_expanders = 4 * grid->getWidth() * grid->getHeight();
+    while (factor >= 2 && hasSharedBlock(seeds, initialGrid->getWidth(), factor)){
+        factor /= 2;
+    }
+    if (factor < 2){
+        initVoronoi(initialGrid);
+        return;
+    }
+    grid = initialGrid;
+    int width = grid->getWidth();
+    int height = grid->getHeight();
+    frontierFilter = FrontierFilter(width, height);
+    voronoiSeeds.reset();
+
+    auto coarseGrid = std::make_shared<Grid<T>>(pyramid::downsample(*grid, factor));
+    ZoneBloater coarseBloater;
+    if constexpr (bloatPolicies::isStatic<Policy>){
+        coarseBloater.policy = policy;
+    } else{
+        coarseBloater.bloatStrategy = std::move(bloatStrategy);
+        coarseBloater.bloatStrategy->setZoneTilePusher(coarseBloater.self());
+    }
+    coarseBloater.initVoronoi(coarseGrid);
+    coarseBloater.runToCompletion();
+    if constexpr (!bloatPolicies::isStatic<Policy>){
+        bloatStrategy = std::move(coarseBloater.bloatStrategy);
+        bloatStrategy->setZoneTilePusher(this->self());
+    }
+
+    int coarseWidth = coarseGrid->getWidth();
+    int coarseHeight = coarseGrid->getHeight();
+    Matrix<bool> refined(coarseWidth, coarseHeight, false);
+    for (int cy = 0; cy < coarseHeight; cy++){
+        for (int cx = 0; cx < coarseWidth; cx++){
+            Identifiable id = coarseGrid->getTileID(cx, cy);
+            for (int dy = -refineBand; dy <= refineBand && !refined.get(cx, cy); dy++){
+                for (int dx = -refineBand; dx <= refineBand; dx++){
+                    auto neighbour = coarseGrid->tryGetID({cx + dx, cy + dy});
+                    if (neighbour && *neighbour != id){
+                        refined.set(cx, cy, true);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    for (const ZoneTile& seed : seeds){
+        refined.set(seed.x / factor, seed.y / factor, true);
+    }
+
+    for (int y = 0; y < height; y++){
+        for (int x = 0; x < width; x++){
+            int cx = x / factor;
+            int cy = y / factor;
+            grid->setTile(x, y, refined.get(cx, cy) ? Identifiable(Identifiable::nullID) : coarseGrid->getTileID(cx, cy));
+        }
+    }
+
+    for (const ZoneTile& seed : seeds){
+        push(seed);
+    }
+    const IntVector2 directions[] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    for (int cy = 0; cy < coarseHeight; cy++){
+        for (int cx = 0; cx < coarseWidth; cx++){
+            if (!refined.get(cx, cy)){
+                continue;
+            }
+            for (int y = cy * factor; y < std::min(height, (cy + 1) * factor); y++){
+                for (int x = cx * factor; x < std::min(width, (cx + 1) * factor); x++){
+                    for (IntVector2 direction : directions){
+                        auto neighbour = grid->tryGetID({x + direction.x, y + direction.y});
+                        if (neighbour && *neighbour != Identifiable::nullID){
+                            push(ZoneTile(x, y, *neighbour));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    max_expanders = 8 * width * height;
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+bool ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::hasSharedBlock(const std::vector<ZoneTile>& seeds, int width, int factor){
+    int coarseWidth = pyramid::downsampledSize(width, factor);
+    std::unordered_map<long long, Identifiable> blockZones;
+    for (const ZoneTile& seed : seeds){
+        long long block = static_cast<long long>(seed.y / factor) * coarseWidth + seed.x / factor;
+        auto [it, inserted] = blockZones.try_emplace(block, seed.zoneID);
+        if (!inserted && it->second != seed.zoneID){
+            return true;
+        }
+    }
+    return false;
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-void ZoneBloater<T, SymEdgeT, AsymEdgeT>::onStart(){
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::onStart(){
     if (!grid){
         finish();
         throw std::invalid_argument("No grid is set!");
     }
+    if (StepRecorder* recorder = getRecorder())
+        recorder->begin(*grid);
+    if constexpr (bloatPolicies::isStatic<Policy>){
+        frontierFilter.setEnqueueOnce(Policy::enqueueOnce);
+    } else{
+        frontierFilter.setEnqueueOnce(bloatStrategy && bloatStrategy->isEnqueueOnce());
+    }
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::onStep(){
+    if (layerPosition == 0)
+        beginLayer();
+    bloatLayer();
+    endLayer();
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::onStepUntil(Clock::time_point deadline){
+    do{
+        beginStep();
+        if (layerPosition == 0)
+            beginLayer();
+        if (!bloatLayer(std::optional<Clock::time_point>(deadline)))
+            return;
+        addSteps(1);
+        endLayer();
+    } while (isRunning() && Clock::now() < deadline);
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-void ZoneBloater<T, SymEdgeT, AsymEdgeT>::onStep(){
-    currentStepSize = nextExpanders.size();
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::beginLayer(){
+    currentExpanders.swap(nextExpanders);
+    nextExpanders.clear();
+    currentStepSize = currentExpanders.size();
     if (currentStepSize > max_expanders)
         throw std::logic_error("Size is more than grid:\t" + std::to_string(currentStepSize) + "\n");
-    for (int i = 0; i < currentStepSize; i++){
-        std::shared_ptr<ZoneTile> activeTile = nextExpanders.front();
-        nextExpanders.pop();
-        bloatStrategy->bloat(*activeTile);
-    }
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::endLayer(){
+    bloatStep++;
     if (nextExpanders.empty())
         finish();
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-void ZoneBloater<T, SymEdgeT, AsymEdgeT>::onReset(){
-    nextExpanders = std::queue<std::shared_ptr<ZoneTile>>();
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::onRun(){
+    if (layerPosition != 0){
+        beginStep();
+        bloatLayer();
+        addSteps(1);
+        endLayer();
+        if (!isRunning())
+            return;
+    }
+    if constexpr (bloatPolicies::isStatic<Policy>){
+        if (pool){
+            runLayers([this]{bloatLayer();});
+        } else{
+            runLayers([this]{bloatLayer(policy);});
+        }
+    } else{
+        // The strategies delegate to these policies, so the pushes and random draws are the same.
+        // Exact type match, a derived strategy may bloat differently
+        if (!bloatStrategy)
+            throw std::logic_error("Bloat mode is not set");
+        const std::type_info& strategyType = typeid(*bloatStrategy);
+        if (strategyType == typeid(bloatStrategies::StraightBloat)){
+            runLayers([this]{bloatLayer(bloatPolicies::Straight{});});
+        } else if (strategyType == typeid(bloatStrategies::ChebyshevBloat)){
+            runLayers([this]{bloatLayer(bloatPolicies::Chebyshev{});});
+        } else if (strategyType == typeid(bloatStrategies::DiagonalRandomBloat)){
+            const auto& strategy = static_cast<const bloatStrategies::DiagonalRandomBloat&>(*bloatStrategy);
+            double chance = strategy.diagonalChance;
+            if (auto seed = strategy.getCounterSeed())
+                runLayers([this, chance, seed]{bloatLayer(bloatPolicies::HashedDiagonalRandom{chance, *seed});});
+            else
+                runLayers([this, chance]{bloatLayer(bloatPolicies::DiagonalRandom{chance});});
+        } else if (strategyType == typeid(bloatStrategies::RandomBloat)){
+            const auto& strategy = static_cast<const bloatStrategies::RandomBloat&>(*bloatStrategy);
+            double chance = strategy.randomChance;
+            if (auto seed = strategy.getCounterSeed())
+                runLayers([this, chance, seed]{bloatLayer(bloatPolicies::HashedRandom{chance, *seed});});
+            else
+                runLayers([this, chance]{bloatLayer(bloatPolicies::Random{chance});});
+        } else if (strategyType == typeid(bloatStrategies::AdjacentCornerFill)){
+            runLayers([this]{bloatLayer(bloatPolicies::AdjacentCornerFill{});});
+        } else{
+            runLayers([this]{bloatLayer();});
+        }
+    }
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+bool ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::bloatLayer(std::optional<Clock::time_point> deadline){
+    if constexpr (bloatPolicies::isParallelSafe<Policy>){
+        if (pool && layerPosition == 0 && currentExpanders.size() >= minParallelStepSize){
+            parallelStep();
+            return true;
+        }
+    }
+    if constexpr (bloatPolicies::isStatic<Policy>){
+        return bloatLayer(policy, deadline);
+    } else{
+        return bloatRest([this](const ZoneTile& activeTile){bloatStrategy->bloat(activeTile);}, deadline);
+    }
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+template <typename StaticPolicy>
+bool ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::bloatLayer(const StaticPolicy& staticPolicy, std::optional<Clock::time_point> deadline){
+    bloatPolicies::GridPusher<T> pusher{*grid, nextExpanders, frontierFilter, bloatStep, getRecorder()};
+    return bloatRest([&](const ZoneTile& activeTile){staticPolicy.bloat(activeTile, pusher);}, deadline);
+}
+
+// Mirrors onStep: every layer is a step, and the last one is the first to push nothing.
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+template <typename LayerBloater>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::runLayers(LayerBloater&& layerBloater){
+    do{
+        beginStep();
+        currentExpanders.swap(nextExpanders);
+        nextExpanders.clear();
+        layerBloater();
+        bloatStep++;
+        addSteps(1);
+    } while (!nextExpanders.empty());
+    finish();
+}
+
+// A scan layer goes over every tile in raster order and bloats the empty ones, which is the same as bloating
+// a frontier of all empty tiles as a tile filled earlier in the scan is skipped either way.
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+template <typename TileBloater>
+bool ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::bloatRest(TileBloater&& tileBloater, std::optional<Clock::time_point> deadline){
+    int width = grid->getWidth();
+    size_t end = scanPending ? static_cast<size_t>(width) * grid->getHeight() : currentExpanders.size();
+    while (layerPosition < end){
+        size_t sliceEnd = deadline ? std::min(end, layerPosition + deadlineCheckInterval) : end;
+        if (scanPending){
+            for (size_t cell = layerPosition; cell < sliceEnd; cell++){
+                int x = cell % width;
+                int y = cell / width;
+                if (grid->isEmpty(x, y))
+                    tileBloater(ZoneTile(x, y, Identifiable::nullID));
+            }
+        } else{
+            for (size_t i = layerPosition; i < sliceEnd; i++){
+                tileBloater(currentExpanders[i]);
+            }
+        }
+        layerPosition = sliceEnd;
+        if (deadline && layerPosition < end && Clock::now() >= *deadline)
+            return false;
+    }
+    layerPosition = 0;
+    scanPending = false;
+    return true;
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::onReset(){
+    currentExpanders.clear();
+    nextExpanders.clear();
+    frontierFilter.clear();
+    bloatStep = 0;
+    scanPending = false;
+    layerPosition = 0;
+    voronoiSeeds.reset();
+    seedField = SeedField();
+    changedCells.clear();
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-void ZoneBloater<T, SymEdgeT, AsymEdgeT>::finishAndReset(){
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::finishAndReset(){
     if (isRunning())
         finish();
     if (isFinished())
         reset();
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-std::shared_ptr<Grid<T>> ZoneBloater<T, SymEdgeT, AsymEdgeT>::getGrid() const{
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+std::shared_ptr<Grid<T>> ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::getGrid() const{
     return grid;
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
 template <typename Strategy>
-requires std::is_base_of_v<BloatStrategy, std::decay_t<Strategy>>
-void ZoneBloater<T, SymEdgeT, AsymEdgeT>::setBloatMode(Strategy&& bloatStrategy){
+requires (std::is_base_of_v<BloatStrategy, std::decay_t<Strategy>> && !bloatPolicies::isStatic<Policy>)
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::setBloatMode(Strategy&& bloatStrategy){
     if (!isInitialized())
         throw std::logic_error("The status is not INIT");
     this->bloatStrategy = std::make_unique<std::decay_t<Strategy>>(std::forward<Strategy>(bloatStrategy));
     this->bloatStrategy->setZoneTilePusher(this->self());
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-void ZoneBloater<T, SymEdgeT, AsymEdgeT>::push(const ZoneTile& zoneTile){
-    nextExpanders.push(std::make_shared<ZoneTile>(zoneTile.x, zoneTile.y, zoneTile.zoneID));
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::setBloatPolicy(const Policy& policy) requires bloatPolicies::isStatic<Policy>{
+    if (!isInitialized())
+        throw std::logic_error("The status is not INIT");
+    this->policy = policy;
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::enableParallelStep(ThreadPool& pool) requires bloatPolicies::isParallelSafe<Policy>{
+    this->pool = &pool;
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::disableParallelStep(){
+    pool = nullptr;
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+long long ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::getAttemptedPushes() const{
+    return frontierFilter.getAttemptedPushes();
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+long long ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::getAcceptedPushes() const{
+    return frontierFilter.getAcceptedPushes();
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::addSeed(IntVector2 point, Identifiable zoneID){
+    prepareSeedField();
+    if (zoneID == Identifiable::nullID)
+        throw std::invalid_argument("Seed zone can't be NullID");
+    int cell = toSeedCell(point);
+    if (seedField.isSeed(cell))
+        throw std::invalid_argument("Tile is already a seed");
+    grid->setTile(point, zoneID);
+    changedCells.clear();
+    seedField.addSeed(cell, changedCells);
+    applySeedChanges();
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::removeSeed(IntVector2 point){
+    prepareSeedField();
+    int cell = toSeedCell(point);
+    if (!seedField.isSeed(cell))
+        throw std::invalid_argument("Tile is not a seed");
+    changedCells.clear();
+    seedField.removeSeed(cell, changedCells);
+    applySeedChanges();
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::moveSeed(IntVector2 from, IntVector2 to){
+    prepareSeedField();
+    int toCell = toSeedCell(to);
+    if (seedField.isSeed(toCell) && from != to)
+        throw std::invalid_argument("Target tile is already a seed");
+    Identifiable zoneID = grid->getTileID(toSeedCell(from) % grid->getWidth(), toSeedCell(from) / grid->getWidth());
+    removeSeed(from);
+    addSeed(to, zoneID);
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+SeedField::Metric ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::getSeedMetric() const{
+    if constexpr (std::same_as<Policy, bloatPolicies::Straight>){
+        return SeedField::Metric::manhattan;
+    } else if constexpr (std::same_as<Policy, bloatPolicies::Chebyshev>){
+        return SeedField::Metric::chebyshev;
+    } else if constexpr (!bloatPolicies::isStatic<Policy>){
+        if (bloatStrategy && typeid(*bloatStrategy) == typeid(bloatStrategies::StraightBloat))
+            return SeedField::Metric::manhattan;
+        if (bloatStrategy && typeid(*bloatStrategy) == typeid(bloatStrategies::ChebyshevBloat))
+            return SeedField::Metric::chebyshev;
+    }
+    throw std::logic_error("Seed edits need StraightBloat or ChebyshevBloat");
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::prepareSeedField(){
+    if (!isFinished())
+        throw std::logic_error("The status is not FINISHED");
+    if (!voronoiSeeds)
+        throw std::logic_error("Seed edits need a bloat started by initVoronoi");
+    SeedField::Metric metric = getSeedMetric();
+    if (!seedField.isEmpty()){
+        return;
+    }
+    seedField = SeedField(grid->getWidth(), grid->getHeight(), metric);
+    std::vector<int> seedCells;
+    for (const ZoneTile& seed : *voronoiSeeds){
+        seedCells.push_back(seed.y * grid->getWidth() + seed.x);
+    }
+    // Writes nothing unless the grid was edited since the bloat
+    seedField.addSeeds(seedCells, changedCells);
+    applySeedChanges();
+    voronoiSeeds->clear();
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+int ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::toSeedCell(IntVector2 point) const{
+    if (!grid->isValidPoint(point))
+        throw std::out_of_range("Seed is out of the grid");
+    return point.y * grid->getWidth() + point.x;
+}
+
+// Seed cells come before the cells they take, so the seed tile already holds the zone
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::applySeedChanges(){
+    int width = grid->getWidth();
+    for (int cell : changedCells){
+        int seed = seedField.getNearest(cell);
+        Identifiable zoneID = seed == SeedField::noSeed ? Identifiable(Identifiable::nullID) : grid->getTileID(seed % width, seed / width);
+        if (grid->getTileID(cell % width, cell / width) != zoneID)
+            grid->setTile(cell % width, cell / width, zoneID);
+    }
+    changedCells.clear();
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::parallelStep(){
+    int width = grid->getWidth();
+    size_t cellCount = static_cast<size_t>(width) * grid->getHeight();
+    if (claims.size() != cellCount){
+        claims = std::vector<std::atomic<uint32_t>>(cellCount);
+        for (auto& claim : claims){
+            claim.store(unclaimed, std::memory_order_relaxed);
+        }
+    }
+    size_t count = currentExpanders.size();
+    size_t chunks = pool->getChunkCount(count);
+    chunkWinners.resize(chunks);
+    chunkFrontiers.resize(chunks);
+
+    pool->parallelFor(count, [&](size_t, size_t begin, size_t end){
+        for (size_t i = begin; i < end; i++){
+            const ZoneTile& tile = currentExpanders[i];
+            if (!grid->isEmpty(tile) || !bloatPolicies::setsTile(policy, tile, bloatStep)){
+                continue;
+            }
+            std::atomic<uint32_t>& claim = claims[tile.y * width + tile.x];
+            uint32_t current = claim.load(std::memory_order_relaxed);
+            while (i < current && !claim.compare_exchange_weak(current, i, std::memory_order_relaxed)){}
+        }
+    });
+    pool->parallelFor(count, [&](size_t chunk, size_t begin, size_t end){
+        chunkWinners[chunk].clear();
+        chunkFrontiers[chunk].clear();
+        ClaimPusher pusher{*grid, claims, chunkWinners[chunk], chunkFrontiers[chunk], 0, bloatStep};
+        for (size_t i = begin; i < end; i++){
+            pusher.index = i;
+            policy.bloat(currentExpanders[i], pusher);
+        }
+    });
+
+    // Chunks hold consecutive frontier ranges, so merging them in order gives the serial push order
+    StepRecorder* recorder = getRecorder();
+    for (size_t chunk = 0; chunk < chunks; chunk++){
+        for (const ZoneTile& winner : chunkWinners[chunk]){
+            grid->setTile(winner.x, winner.y, winner.zoneID);
+            if (recorder)
+                recorder->record(winner.y * width + winner.x, winner.zoneID.getID());
+            claims[winner.y * width + winner.x].store(unclaimed, std::memory_order_relaxed);
+        }
+        for (const ZoneTile& zoneTile : chunkFrontiers[chunk]){
+            if (frontierFilter.accept(zoneTile, grid->isEmpty(zoneTile)))
+                nextExpanders.push_back(zoneTile);
+        }
+    }
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::push(const ZoneTile& zoneTile){
+    if (frontierFilter.accept(zoneTile, grid->isEmpty(zoneTile)))
+        nextExpanders.push_back(zoneTile);
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-void ZoneBloater<T, SymEdgeT, AsymEdgeT>::setZoneTile(const ZoneTile &zoneTile){
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::setZoneTile(const ZoneTile &zoneTile){
     grid->setTile(zoneTile.x, zoneTile.y, zoneTile.zoneID);
+    if (StepRecorder* recorder = getRecorder())
+        recorder->record(zoneTile.y * grid->getWidth() + zoneTile.x, zoneTile.zoneID.getID());
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-bool ZoneBloater<T, SymEdgeT, AsymEdgeT>::isEmpty(IntVector2 point) const{
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+bool ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::isEmpty(IntVector2 point) const{
     return grid->isEmpty(point);
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-bool ZoneBloater<T, SymEdgeT, AsymEdgeT>::isValidPoint(IntVector2 point) const{
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+bool ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::isValidPoint(IntVector2 point) const{
     return grid->isValidPoint(point);
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-std::optional<Identifiable> ZoneBloater<T, SymEdgeT, AsymEdgeT>::tryGetID(IntVector2 point) const{
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+std::optional<Identifiable> ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::tryGetID(IntVector2 point) const{
     return grid->tryGetID(point);
 }
 
-template <typename T, typename SymEdgeT, typename AsymEdgeT>
-void ZoneBloater<T, SymEdgeT, AsymEdgeT>::setEdgeExpanders(const std::unordered_map<Identifiable, IntVector2, IDHash>& startingPoints, const EdgeGraph<T, SymEdgeT, AsymEdgeT>& graph){
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+long long ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::getBloatStep() const{
+    return bloatStep;
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+long long ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::getChangedCells() const{
+    return grid ? grid->getChangeCount() : 0;
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+long long ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::getFrontierSize() const{
+    return layerPosition == 0 ? nextExpanders.size() : currentExpanders.size();
+}
+
+template <typename T, typename SymEdgeT, typename AsymEdgeT, typename Policy>
+void ZoneBloater<T, SymEdgeT, AsymEdgeT, Policy>::setEdgeExpanders(const IDMap<IntVector2>& startingPoints, const EdgeGraph<T, SymEdgeT, AsymEdgeT>& graph){
     double ratio = 0.5;
     
     for (const auto& [nodePair, edge] : graph.getSymEdges()){
@@ -184,10 +750,10 @@ void ZoneBloater<T, SymEdgeT, AsymEdgeT>::setEdgeExpanders(const std::unordered_
         }
         size_t upperBound = static_cast<size_t>(ratio * line.size());
         for (size_t i = 0; i < upperBound; i++){
-            nextExpanders.push(std::make_shared<ZoneTile>(line[i], nodePair.first));
+            nextExpanders.emplace_back(line[i], nodePair.first);
         }
         for (size_t i = upperBound; i < line.size(); i++){
-            nextExpanders.push(std::make_shared<ZoneTile>(line[i], nodePair.second));
+            nextExpanders.emplace_back(line[i], nodePair.second);
         }
     }
 }
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+#include "2d.h"
+#include "identifiable.h"
+#include "id_map.h"
+
+struct ZoneBounds{
+    IntVector2 min;
+    IntVector2 max;
+};
+
+// Per-zone area, bounding box and centroid, updated on every tile change. Queries and adding a tile are O(1)
+// (a zone's first tile allocates its row and column counts). Bounds stay exact on removal: the per-zone row and
+// column counts let them shrink without a rescan of the zone, but removing a tile on the bounding box walks them
+// to the next occupied row or column, O(width + height) in the worst case.
+class ZoneStatistics{
+    public:
+        ZoneStatistics() = default;
+        ZoneStatistics(int width, int height);
+
+        // nullID on either side is ignored
+        void change(Identifiable from, Identifiable to, int x, int y);
+        void add(Identifiable zone, int x, int y);
+        void remove(Identifiable zone, int x, int y);
+        void clear();
+
+        bool contains(Identifiable zone) const;
+        int getArea(Identifiable zone) const;
+        ZoneBounds getBounds(Identifiable zone) const;
+        DoubleVector2 getCentroid(Identifiable zone) const;
+
+    private:
+        struct Zone{
+            int area = 0;
+            long long sumX = 0;
+            long long sumY = 0;
+            ZoneBounds bounds;
+            std::vector<int> rowCounts;
+            std::vector<int> columnCounts;
+        };
+        const Zone& getZone(Identifiable zone) const;
+
+        int width = 0;
+        int height = 0;
+        IDMap<Zone> zones;
+};
@@ -0,0 +1,377 @@
+#include "blender.h"
+
+#include <numeric>
+#include <format>
+#include <stdexcept>
+
+namespace{
+
+    // Zones are ConnectionTable indices here
+    struct SparseGuarantorElement{
+        IntVector2 coords;
+        int zoneApplied;
+        int asymParamIndex;
+        double weightSpread;
+    };
+
+    struct SparseBlendElement{
+        IntVector2 coords;
+        int spreadingZone;
+        int blendDistance;
+        int iterationsLeft;
+    };
+
+    // Blend influences of the tiles as linked lists in one pool, a tile is reached by a few zones at most.
+    class BlendInfluences{
+        public:
+            static constexpr int none = -1;
+
+            explicit BlendInfluences(size_t tileCount) : heads(tileCount, none){};
+
+            // nullptr when the zone didn't reach the tile
+            double* find(size_t tile, int zone){
+                for (int entry = heads[tile]; entry != none; entry = entries[entry].next){
+                    if (entries[entry].zone == zone)
+                        return &entries[entry].weight;
+                }
+                return nullptr;
+            };
+            void add(size_t tile, int zone, double weight){
+                entries.push_back({zone, weight, heads[tile]});
+                heads[tile] = static_cast<int>(entries.size()) - 1;
+            };
+            template <typename F>
+            void forEach(size_t tile, F&& function) const{
+                for (int entry = heads[tile]; entry != none; entry = entries[entry].next){
+                    function(entries[entry].zone, entries[entry].weight);
+                }
+            };
+            size_t size() const{return entries.size();};
+
+        private:
+            struct Entry{
+                int zone;
+                double weight;
+                int next;
+            };
+
+            std::vector<int> heads;
+            std::vector<Entry> entries;
+    };
+}
+
+SparseZoneMasks::SparseZoneMasks(
+        int width,
+        int height,
+        std::vector<Identifiable> zoneIDs,
+        std::vector<Identifiable> tileZones,
+        std::vector<double> bonuses,
+        std::vector<size_t> influenceOffsets,
+        std::vector<ZoneWeight> influences
+    ) :
+    width(width),
+    height(height),
+    zoneIDs(std::move(zoneIDs)),
+    tileZones(std::move(tileZones)),
+    bonuses(std::move(bonuses)),
+    influenceOffsets(std::move(influenceOffsets)),
+    influences(std::move(influences)){
+    size_t tileCount = static_cast<size_t>(width) * height;
+    if (this->tileZones.size() != tileCount || this->bonuses.size() != tileCount || this->influenceOffsets.size() != tileCount + 1){
+        throw std::invalid_argument("SparseZoneMasks: buffer sizes don't match the size");
+    }
+}
+
+Identifiable SparseZoneMasks::getZone(int x, int y) const{
+    return tileZones[getTileIndex(x, y)];
+}
+
+std::span<const ZoneWeight> SparseZoneMasks::getInfluences(int x, int y) const{
+    size_t tile = getTileIndex(x, y);
+    return std::span<const ZoneWeight>(influences).subspan(influenceOffsets[tile], influenceOffsets[tile + 1] - influenceOffsets[tile]);
+}
+
+double SparseZoneMasks::getInfluence(Identifiable zone, int x, int y) const{
+    for (const ZoneWeight& influence : getInfluences(x, y)){
+        if (influence.zone == zone)
+            return influence.weight;
+    }
+    return 0.0;
+}
+
+double SparseZoneMasks::getBonus(Identifiable zone, int x, int y) const{
+    size_t tile = getTileIndex(x, y);
+    return tileZones[tile] == zone ? bonuses[tile] : 0.0;
+}
+
+ZoneMasks SparseZoneMasks::toZoneMasks() const{
+    ZoneMasks masks;
+    for (Identifiable zone : zoneIDs){
+        masks.bonusMask[zone] = Matrix<double>(width, height, 0.0);
+        masks.influenceMask[zone] = Matrix<double>(width, height, 0.0);
+    }
+    for (int y = 0; y < height; y++){
+        for (int x = 0; x < width; x++){
+            size_t tile = static_cast<size_t>(y) * width + x;
+            if (tileZones[tile] != Identifiable::nullID){
+                masks.bonusMask.at(tileZones[tile]).set(x, y, bonuses[tile]);
+            }
+            for (const ZoneWeight& influence : getInfluences(x, y)){
+                masks.influenceMask.at(influence.zone).set(x, y, influence.weight);
+            }
+        }
+    }
+    return masks;
+}
+
+size_t SparseZoneMasks::getTileIndex(int x, int y) const{
+    if (x < 0 || y < 0 || x >= width || y >= height){
+        throw std::out_of_range("SparseZoneMasks: tile is out of the masks");
+    }
+    return static_cast<size_t>(y) * width + x;
+}
+
+Generator<StageProgress> blendLabelsSparseStaged(
+        std::vector<int> labels,
+        int width,
+        int height,
+        BasicConnectionTable connections,
+        std::queue<BFSIntakeElement> bfsIntakeQueue,
+        SparseZoneMasks& result
+    ){
+    auto isValidPoint = [width, height](IntVector2 point){
+        return point.x >= 0 && point.y >= 0 && point.x < width && point.y < height;
+    };
+    auto getTile = [width](IntVector2 point){
+        return static_cast<size_t>(point.y) * width + point.x;
+    };
+
+    long long processed = 0;
+    while (!bfsIntakeQueue.empty()){
+        if (++processed % blendYieldInterval == 0)
+            co_yield StageProgress{StagePhase::blendIntake, processed};
+        BFSIntakeElement bfsElement = bfsIntakeQueue.front();
+        bfsIntakeQueue.pop();
+        if (
+            !isValidPoint(bfsElement.coords)
+            || labels[getTile(bfsElement.coords)] != bfsElement.intakingZone.getID()
+            || bfsElement.iterationsLeft < 1
+        ){
+            continue;
+        }
+        labels[getTile(bfsElement.coords)] = bfsElement.spreadingZone.getID();
+        for (IntVector2 next : {
+            IntVector2{bfsElement.coords.x+1, bfsElement.coords.y},
+            IntVector2{bfsElement.coords.x-1, bfsElement.coords.y},
+            IntVector2{bfsElement.coords.x, bfsElement.coords.y+1},
+            IntVector2{bfsElement.coords.x, bfsElement.coords.y-1}
+        }){
+            bfsIntakeQueue.push({next, bfsElement.intakingZone, bfsElement.spreadingZone, bfsElement.iterationsLeft - 1});
+        }
+    }
+    co_yield StageProgress{StagePhase::blendIntake, processed};
+    // Intake end, starting guarantor
+
+    const int absent = BasicConnectionTable::absent;
+    std::vector<int> zones(labels.size());
+    for (size_t tile = 0; tile < labels.size(); tile++){
+        if (labels[tile] == Identifiable::nullID){
+            zones[tile] = absent;
+            continue;
+        }
+        zones[tile] = connections.getIndex(labels[tile]);
+        if (zones[tile] == absent){
+            throw std::invalid_argument(std::format("blendConnectionsSparse: zone {} is not in the template", labels[tile]));
+        }
+    }
+    // blendConnections seeds the queues zone by zone in ascending ID order, the seeds are bucketed by
+    // the zone's position in that order to push them in the same order from one pass
+    std::vector<int> zonesByID(connections.size());
+    std::iota(zonesByID.begin(), zonesByID.end(), 0);
+    std::sort(zonesByID.begin(), zonesByID.end(), [&connections](int first, int second){
+        return connections.getID(first) < connections.getID(second);
+    });
+    std::vector<int> zoneOrder(connections.size());
+    for (int i = 0; i < connections.size(); i++){
+        zoneOrder[zonesByID[i]] = i;
+    }
+
+    std::vector<std::vector<SparseGuarantorElement>> guarantorSeeds(connections.size());
+    std::vector<std::vector<SparseBlendElement>> blendSeeds(connections.size());
+    for (int y = 0; y < height; ++y){
+        for (int x = 0; x < width; ++x){
+            int zone = zones[getTile({x, y})];
+            if (zone == absent){
+                continue;
+            }
+            for (IntVector2 neighbour : {IntVector2{x+1, y}, IntVector2{x-1, y}, IntVector2{x, y+1}, IntVector2{x, y-1}}){
+                if (!isValidPoint(neighbour)){
+                    continue;
+                }
+                int neighbourZone = zones[getTile(neighbour)];
+                if (neighbourZone == absent || neighbourZone == zone){
+                    continue;
+                }
+                // The neighbouring tile's zone gets the guaranteed area and spreads the blend from there
+                int asymParamIndex = connections.getAsymParamIndex(neighbourZone, zone);
+                if (asymParamIndex != absent){
+                    guarantorSeeds[zoneOrder[zone]].push_back({
+                        neighbour,
+                        neighbourZone,
+                        asymParamIndex,
+                        connections.getAsymParams(asymParamIndex).bonusValue
+                    });
+                }
+                int symParamIndex = connections.getSymParamIndex(neighbourZone, zone);
+                if (symParamIndex != absent){
+                    int blendDistance = connections.getSymParams(symParamIndex).blendDistance;
+                    blendSeeds[zoneOrder[zone]].push_back({neighbour, neighbourZone, blendDistance, blendDistance});
+                }
+            }
+        }
+        co_yield StageProgress{StagePhase::blendGuarantor, 0};
+    }
+
+    std::vector<double> bonuses(labels.size(), 0.0);
+    // Indexed by the asym edge parameters index of the connection table
+    std::vector<int> areaLeft(connections.getAsymParamsCount());
+    for (int i = 0; i < connections.getAsymParamsCount(); i++){
+        areaLeft[i] = connections.getAsymParams(i).areaGuaranteed;
+    }
+    std::queue<SparseGuarantorElement> bfsGuarantorQueue;
+    for (int zone : zonesByID){
+        for (const SparseGuarantorElement& seed : guarantorSeeds[zoneOrder[zone]]){
+            bfsGuarantorQueue.push(seed);
+        }
+    }
+    guarantorSeeds.clear();
+
+    processed = 0;
+    while (!bfsGuarantorQueue.empty()){
+        if (++processed % blendYieldInterval == 0)
+            co_yield StageProgress{StagePhase::blendGuarantor, processed};
+        SparseGuarantorElement bfsElement = bfsGuarantorQueue.front();
+        bfsGuarantorQueue.pop();
+        if (
+            !isValidPoint(bfsElement.coords)
+            || zones[getTile(bfsElement.coords)] != bfsElement.zoneApplied
+            || bonuses[getTile(bfsElement.coords)] >= bfsElement.weightSpread
+            || areaLeft[bfsElement.asymParamIndex] < 1
+        ){
+            continue;
+        }
+        bonuses[getTile(bfsElement.coords)] += bfsElement.weightSpread;
+        areaLeft[bfsElement.asymParamIndex]--;
+        for (IntVector2 next : {
+            IntVector2{bfsElement.coords.x-1, bfsElement.coords.y},
+            IntVector2{bfsElement.coords.x+1, bfsElement.coords.y},
+            IntVector2{bfsElement.coords.x, bfsElement.coords.y-1},
+            IntVector2{bfsElement.coords.x, bfsElement.coords.y+1}
+        }){
+            bfsGuarantorQueue.push({next, bfsElement.zoneApplied, bfsElement.asymParamIndex, bfsElement.weightSpread});
+        }
+    }
+    co_yield StageProgress{StagePhase::blendGuarantor, processed};
+    // Guarantor end, starting blend
+
+    std::queue<SparseBlendElement> bfsBlendQueue;
+    for (int zone : zonesByID){
+        for (const SparseBlendElement& seed : blendSeeds[zoneOrder[zone]]){
+            bfsBlendQueue.push(seed);
+        }
+    }
+    blendSeeds.clear();
+
+    BlendInfluences blendInfluences(labels.size());
+    processed = 0;
+    while (!bfsBlendQueue.empty()){
+        if (++processed % blendYieldInterval == 0)
+            co_yield StageProgress{StagePhase::blendSpread, processed};
+        SparseBlendElement bfsElement = bfsBlendQueue.front();
+        bfsBlendQueue.pop();
+        if (
+            !isValidPoint(bfsElement.coords)
+            || zones[getTile(bfsElement.coords)] == absent
+            || bfsElement.iterationsLeft < 1
+        ){
+            continue;
+        }
+        size_t tile = getTile(bfsElement.coords);
+        double influence = (bfsElement.iterationsLeft + 1.0) / (bfsElement.blendDistance + 1.0);
+        double* blendInfluence = blendInfluences.find(tile, bfsElement.spreadingZone);
+        if (blendInfluence && *blendInfluence >= influence){
+            continue;
+        }
+        if (zones[tile] == bfsElement.spreadingZone){
+            influence = 1.0;
+        }
+        if (blendInfluence){
+            *blendInfluence = influence;
+        } else{
+            blendInfluences.add(tile, bfsElement.spreadingZone, influence);
+        }
+        for (IntVector2 next : {
+            IntVector2{bfsElement.coords.x+1, bfsElement.coords.y},
+            IntVector2{bfsElement.coords.x-1, bfsElement.coords.y},
+            IntVector2{bfsElement.coords.x, bfsElement.coords.y+1},
+            IntVector2{bfsElement.coords.x, bfsElement.coords.y-1}
+        }){
+            bfsBlendQueue.push({next, bfsElement.spreadingZone, bfsElement.blendDistance, bfsElement.iterationsLeft - 1});
+        }
+    }
+    co_yield StageProgress{StagePhase::blendSpread, processed};
+
+    // A tile's own zone has the blend influence 1.0 whether the blend reached it or not. The influences are
+    // summed in ascending zone ID order as blendConnections sums them, so the quotients are the same.
+    processed = 0;
+    std::vector<size_t> influenceOffsets;
+    influenceOffsets.reserve(labels.size() + 1);
+    influenceOffsets.push_back(0);
+    std::vector<ZoneWeight> influences;
+    influences.reserve(blendInfluences.size() + labels.size());
+    for (int y = 0; y < height; ++y){
+        for (int x = 0; x < width; ++x){
+            size_t tile = getTile({x, y});
+            if (zones[tile] != absent){
+                auto rowBegin = influences.size();
+                bool ownZoneReached = false;
+                blendInfluences.forEach(tile, [&](int zone, double weight){
+                    influences.push_back({connections.getID(zone), weight});
+                    ownZoneReached = ownZoneReached || zone == zones[tile];
+                });
+                if (!ownZoneReached){
+                    influences.push_back({connections.getID(zones[tile]), 1.0});
+                }
+                std::sort(influences.begin() + rowBegin, influences.end(), [](const ZoneWeight& first, const ZoneWeight& second){
+                    return first.zone < second.zone;
+                });
+                double sum = 0.0;
+                for (auto it = influences.begin() + rowBegin; it != influences.end(); ++it){
+                    sum += it->weight;
+                }
+                for (auto it = influences.begin() + rowBegin; it != influences.end(); ++it){
+                    it->weight /= sum;
+                }
+            }
+            influenceOffsets.push_back(influences.size());
+        }
+        co_yield StageProgress{StagePhase::blendNormalize, ++processed};
+    }
+
+    std::vector<Identifiable> zoneIDs;
+    zoneIDs.reserve(zonesByID.size());
+    for (int zone : zonesByID){
+        zoneIDs.push_back(connections.getID(zone));
+    }
+    std::vector<Identifiable> tileZones(labels.begin(), labels.end());
+    result = SparseZoneMasks(
+        width,
+        height,
+        std::move(zoneIDs),
+        std::move(tileZones),
+        std::move(bonuses),
+        std::move(influenceOffsets),
+        std::move(influences)
+    );
+    co_yield StageProgress{StagePhase::blendNormalize, processed};
+}
@@ -0,0 +1,219 @@
+#include "components.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace components;
+
+namespace{
+    constexpr int backgroundParent = -1;
+
+    int findRoot(std::vector<int>& parent, int i){
+        while (parent[i] != i){
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    // The smaller index always becomes the root, so each root is the first cell of its component in raster order.
+    void unite(std::vector<int>& parent, int a, int b){
+        a = findRoot(parent, a);
+        b = findRoot(parent, b);
+        if (a < b){
+            parent[b] = a;
+        } else if (b < a){
+            parent[a] = b;
+        }
+    }
+
+    // Links row y with the row above it.
+    void linkUpperRow(const std::vector<int>& values, std::vector<int>& parent, int width, int y, Connectivity connectivity){
+        int row = y * width;
+        int upperRow = row - width;
+        for (int x = 0; x < width; x++){
+            int value = values[row + x];
+            if (value == Identifiable::nullID){
+                continue;
+            }
+            if (values[upperRow + x] == value){
+                unite(parent, row + x, upperRow + x);
+            }
+            if (connectivity == Connectivity::four){
+                continue;
+            }
+            if (x > 0 && values[upperRow + x - 1] == value){
+                unite(parent, row + x, upperRow + x - 1);
+            }
+            if (x + 1 < width && values[upperRow + x + 1] == value){
+                unite(parent, row + x, upperRow + x + 1);
+            }
+        }
+    }
+
+    // First pass over rows [rowBegin, rowEnd), touches no cell outside of them.
+    void labelRows(const std::vector<int>& values, std::vector<int>& parent, int width, int rowBegin, int rowEnd, Connectivity connectivity){
+        for (int y = rowBegin; y < rowEnd; y++){
+            bool hasUpper = y > rowBegin;
+            int row = y * width;
+            for (int x = 0; x < width; x++){
+                int i = row + x;
+                int value = values[i];
+                if (value == Identifiable::nullID){
+                    parent[i] = backgroundParent;
+                    continue;
+                }
+                parent[i] = i;
+                bool sameLeft = x > 0 && values[i - 1] == value;
+                if (!hasUpper){
+                    if (sameLeft){
+                        unite(parent, i, i - 1);
+                    }
+                    continue;
+                }
+                int upper = i - width;
+                if (values[upper] == value){
+                    unite(parent, i, upper);
+                    // With 8-connectivity left, upper-left and upper-right cells are already linked through the upper one
+                    if (sameLeft && connectivity == Connectivity::four){
+                        unite(parent, i, i - 1);
+                    }
+                    continue;
+                }
+                if (connectivity == Connectivity::eight){
+                    if (x + 1 < width && values[upper + 1] == value){
+                        unite(parent, i, upper + 1);
+                    }
+                    if (!sameLeft && x > 0 && values[upper - 1] == value){
+                        unite(parent, i, upper - 1);
+                    }
+                }
+                if (sameLeft){
+                    unite(parent, i, i - 1);
+                }
+            }
+        }
+    }
+
+    Labeling resolve(const std::vector<int>& values, std::vector<int>& parent, int width, int height, ThreadPool* pool){
+        std::vector<int> labels(parent.size());
+        auto findRoots = [&](size_t, size_t begin, size_t end){
+            for (size_t i = begin; i < end; i++){
+                int root = parent[i];
+                if (root != backgroundParent){
+                    while (parent[root] != root){
+                        root = parent[root];
+                    }
+                }
+                labels[i] = root;
+            }
+        };
+        if (pool){
+            pool->parallelFor(labels.size(), findRoots);
+        } else{
+            findRoots(0, 0, labels.size());
+        }
+
+        // Roots are no longer needed as parents, they store the final label of their component instead.
+        std::vector<Component> components;
+        for (int y = 0; y < height; y++){
+            for (int x = 0; x < width; x++){
+                int i = y * width + x;
+                int root = labels[i];
+                if (root == backgroundParent){
+                    labels[i] = Labeling::background;
+                    continue;
+                }
+                if (root == i){
+                    parent[i] = components.size();
+                    components.push_back(Component{
+                        .zoneID = values[i],
+                        .area = 0,
+                        .min = {x, y},
+                        .max = {x, y}
+                    });
+                }
+                int label = parent[root];
+                labels[i] = label;
+                Component& component = components[label];
+                component.area++;
+                component.min.x = std::min(component.min.x, x);
+                component.max.x = std::max(component.max.x, x);
+                component.max.y = y;
+            }
+        }
+        return Labeling(width, height, std::move(labels), std::move(components));
+    }
+
+    void checkDimension(const std::vector<int>& values, int width, int height){
+        if (width < 0 || height < 0 || values.size() != static_cast<size_t>(width) * height){
+            throw std::invalid_argument("components::label: values size doesn't match the dimension");
+        }
+    }
+}
+
+Labeling::Labeling(int width, int height, std::vector<int> labels, std::vector<Component> components) :
+    width(width),
+    height(height),
+    labels(std::move(labels)),
+    components(std::move(components)){}
+
+int Labeling::getLabel(int x, int y) const{
+    if (x < 0 || y < 0 || x >= width || y >= height){
+        throw std::out_of_range("Labeling::getLabel: point is out of range");
+    }
+    return labels[y * width + x];
+}
+
+int Labeling::getLabel(IntVector2 point) const{
+    return getLabel(point.x, point.y);
+}
+
+const Component &Labeling::getComponent(int label) const{
+    return components.at(label);
+}
+
+size_t Labeling::countComponents(Identifiable zoneID) const{
+    return std::count_if(components.begin(), components.end(), [zoneID](const Component& component){
+        return component.zoneID == zoneID;
+    });
+}
+
+Labeling components::label(const std::vector<int>& values, int width, int height, Connectivity connectivity){
+    checkDimension(values, width, height);
+    std::vector<int> parent(values.size());
+    labelRows(values, parent, width, 0, height, connectivity);
+    return resolve(values, parent, width, height, nullptr);
+}
+
+Labeling components::labelParallel(const std::vector<int>& values, int width, int height, Connectivity connectivity, ThreadPool& pool){
+    checkDimension(values, width, height);
+    std::vector<int> parent(values.size());
+    size_t strips = pool.getChunkCount(height);
+    pool.parallelFor(height, [&](size_t, size_t rowBegin, size_t rowEnd){
+        labelRows(values, parent, width, rowBegin, rowEnd, connectivity);
+    });
+    for (size_t strip = 1; strip < strips; strip++){
+        linkUpperRow(values, parent, width, ThreadPool::chunkBegin(height, strips, strip), connectivity);
+    }
+    return resolve(values, parent, width, height, &pool);
+}
+
+Labeling components::label(const Matrix<bool>& mask, Connectivity connectivity){
+    return label(toValues(mask), mask.getWidth(), mask.getHeight(), connectivity);
+}
+
+Labeling components::labelParallel(const Matrix<bool>& mask, Connectivity connectivity, ThreadPool& pool){
+    return labelParallel(toValues(mask), mask.getWidth(), mask.getHeight(), connectivity, pool);
+}
+
+std::vector<int> components::toValues(const Matrix<bool>& mask){
+    std::vector<int> values;
+    values.reserve(static_cast<size_t>(mask.getWidth()) * mask.getHeight());
+    for (int y = 0; y < mask.getHeight(); y++){
+        for (int x = 0; x < mask.getWidth(); x++){
+            values.push_back(mask.get(x, y) ? 0 : Identifiable::nullID);
+        }
+    }
+    return values;
+}
@@ -0,0 +1,160 @@
+#include "distance_transform.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace distanceTransform;
+
+namespace{
+    constexpr int noRow = -1;
+
+    // Row of the nearest seed in the same column for columns [columnBegin, columnEnd), noRow when the column is empty.
+    // Sweeps go row by row so the memory is read in order.
+    void nearestInColumns(const std::vector<int>& values, std::vector<int>& seedRows, int width, int height, int columnBegin, int columnEnd){
+        for (int y = 0; y < height; y++){
+            int row = y * width;
+            for (int x = columnBegin; x < columnEnd; x++){
+                int i = row + x;
+                if (values[i] != Identifiable::nullID){
+                    seedRows[i] = y;
+                } else{
+                    seedRows[i] = y > 0 ? seedRows[i - width] : noRow;
+                }
+            }
+        }
+        for (int y = height - 2; y >= 0; y--){
+            int row = y * width;
+            for (int x = columnBegin; x < columnEnd; x++){
+                int i = row + x;
+                int lower = seedRows[i + width];
+                if (lower == noRow){
+                    continue;
+                }
+                // Strictly closer, so a tie keeps the upper seed
+                if (seedRows[i] == noRow || lower - y < y - seedRows[i]){
+                    seedRows[i] = lower;
+                }
+            }
+        }
+    }
+
+    // Lower envelope of the parabolas (x - q)^2 + (seedRow(q) - y)^2 over the columns q of a row.
+    // sites and bounds are scratch buffers of at least width and width + 1 elements.
+    void nearestInRows(const std::vector<int>& seedRows, std::vector<int>& nearest, std::vector<long long>& squaredDistances,
+                       int width, int rowBegin, int rowEnd, std::vector<int>& sites, std::vector<double>& bounds){
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+        for (int y = rowBegin; y < rowEnd; y++){
+            int row = y * width;
+            auto height = [&](int q){
+                long long dy = seedRows[row + q] - y;
+                return dy * dy + static_cast<long long>(q) * q;
+            };
+
+            int k = -1;
+            for (int q = 0; q < width; q++){
+                if (seedRows[row + q] == noRow){
+                    continue;
+                }
+                double intersection = -infinity;
+                while (k >= 0){
+                    intersection = static_cast<double>(height(q) - height(sites[k])) / (2.0 * (q - sites[k]));
+                    // On equality the left parabolas win the intersection point, so the top one is never needed
+                    if (intersection > bounds[k]){
+                        break;
+                    }
+                    k--;
+                }
+                k++;
+                sites[k] = q;
+                bounds[k] = k == 0 ? -infinity : intersection;
+                bounds[k + 1] = infinity;
+            }
+
+            if (k < 0){
+                for (int x = 0; x < width; x++){
+                    nearest[row + x] = NearestSeeds::noSeed;
+                    squaredDistances[row + x] = -1;
+                }
+                continue;
+            }
+            k = 0;
+            for (int x = 0; x < width; x++){
+                while (bounds[k + 1] < x){
+                    k++;
+                }
+                int q = sites[k];
+                long long dx = x - q;
+                long long dy = seedRows[row + q] - y;
+                nearest[row + x] = seedRows[row + q] * width + q;
+                squaredDistances[row + x] = dx * dx + dy * dy;
+            }
+        }
+    }
+
+    void checkDimension(const std::vector<int>& values, int width, int height){
+        if (width < 0 || height < 0 || values.size() != static_cast<size_t>(width) * height){
+            throw std::invalid_argument("distanceTransform::compute: values size doesn't match the dimension");
+        }
+    }
+}
+
+NearestSeeds::NearestSeeds(int width, int height, std::vector<int> nearest, std::vector<long long> squaredDistances) :
+    width(width),
+    height(height),
+    nearest(std::move(nearest)),
+    squaredDistances(std::move(squaredDistances)){}
+
+int NearestSeeds::getNearest(int x, int y) const{
+    if (x < 0 || y < 0 || x >= width || y >= height){
+        throw std::out_of_range("NearestSeeds::getNearest: point is out of range");
+    }
+    return nearest[y * width + x];
+}
+
+IntVector2 NearestSeeds::getNearestPoint(int x, int y) const{
+    int seed = getNearest(x, y);
+    if (seed == noSeed){
+        throw std::logic_error("NearestSeeds::getNearestPoint: there are no seeds");
+    }
+    return {seed % width, seed / width};
+}
+
+long long NearestSeeds::getSquaredDistance(int x, int y) const{
+    if (getNearest(x, y) == noSeed){
+        throw std::logic_error("NearestSeeds::getSquaredDistance: there are no seeds");
+    }
+    return squaredDistances[y * width + x];
+}
+
+double NearestSeeds::getDistance(int x, int y) const{
+    return std::sqrt(static_cast<double>(getSquaredDistance(x, y)));
+}
+
+NearestSeeds distanceTransform::compute(const std::vector<int>& values, int width, int height){
+    checkDimension(values, width, height);
+    std::vector<int> seedRows(values.size());
+    std::vector<int> nearest(values.size());
+    std::vector<long long> squaredDistances(values.size());
+    nearestInColumns(values, seedRows, width, height, 0, width);
+    std::vector<int> sites(width);
+    std::vector<double> bounds(width + 1);
+    nearestInRows(seedRows, nearest, squaredDistances, width, 0, height, sites, bounds);
+    return NearestSeeds(width, height, std::move(nearest), std::move(squaredDistances));
+}
+
+NearestSeeds distanceTransform::computeParallel(const std::vector<int>& values, int width, int height, ThreadPool& pool){
+    checkDimension(values, width, height);
+    std::vector<int> seedRows(values.size());
+    std::vector<int> nearest(values.size());
+    std::vector<long long> squaredDistances(values.size());
+    pool.parallelFor(width, [&](size_t, size_t columnBegin, size_t columnEnd){
+        nearestInColumns(values, seedRows, width, height, columnBegin, columnEnd);
+    });
+    pool.parallelFor(height, [&](size_t, size_t rowBegin, size_t rowEnd){
+        std::vector<int> sites(width);
+        std::vector<double> bounds(width + 1);
+        nearestInRows(seedRows, nearest, squaredDistances, width, rowBegin, rowEnd, sites, bounds);
+    });
+    return NearestSeeds(width, height, std::move(nearest), std::move(squaredDistances));
+}
@@ -0,0 +1,16 @@
+#include "frontier_filter.h"
+
+FrontierFilter::FrontierFilter(int width, int height) :
+    width(width),
+    enqueued(static_cast<size_t>(width) * height, false){}
+
+void FrontierFilter::setEnqueueOnce(bool enqueueOnce){
+    this->enqueueOnce = enqueueOnce;
+}
+
+void FrontierFilter::clear(){
+    enqueued.assign(enqueued.size(), false);
+    enqueueOnce = false;
+    attemptedPushes = 0;
+    acceptedPushes = 0;
+}
@@ -3,6 +3,19 @@
 #include <stdexcept>
 #include <numeric>
 
+namespace{
+    uint64_t splitMix(uint64_t value){
+        value += 0x9E3779B97F4A7C15;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+        return value ^ (value >> 31);
+    }
+
+    uint64_t pack(int high, int low){
+        return (static_cast<uint64_t>(static_cast<uint32_t>(high)) << 32) | static_cast<uint32_t>(low);
+    }
+}
+
 RandomGenerator::RandomGenerator(){
     generateSeed();
 }
@@ -65,3 +78,17 @@ unsigned int RandomGenerator::generateSeed(){
     setSeed(seed);
     return seed;
 }
+
+uint64_t RandomGenerator::counterHash(uint64_t seed, int x, int y, int zone, long long step, int stream){
+    uint64_t hash = splitMix(seed ^ splitMix(pack(x, y)));
+    hash = splitMix(hash ^ pack(zone, stream));
+    return splitMix(hash ^ static_cast<uint64_t>(step));
+}
+
+bool RandomGenerator::counterChanceOccurred(double probability, uint64_t hash){
+    if (probability < 0.0 || probability > 1.0) {
+        throw std::invalid_argument("Probability must be between 0.0 and 1.0");
+    }
+    // Top 53 bits as a double in [0, 1)
+    return static_cast<double>(hash >> 11) * 0x1.0p-53 < probability;
+}
@@ -0,0 +1,118 @@
+#include "seed_field.h"
+
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+
+SeedField::SeedField(int width, int height, Metric metric) :
+    width(width),
+    height(height),
+    metric(metric),
+    nearest(static_cast<size_t>(width) * height, noSeed){}
+
+void SeedField::addSeeds(const std::vector<int>& seeds, std::vector<int>& changed){
+    queue.clear();
+    for (int seed : seeds){
+        checkCell(seed);
+        if (isSeed(seed)){
+            throw std::invalid_argument("SeedField::addSeeds: cell is already a seed");
+        }
+        queue.push(0, {seed, seed});
+    }
+    spread(changed);
+}
+
+void SeedField::addSeed(int seed, std::vector<int>& changed){
+    addSeeds({seed}, changed);
+}
+
+// The cells of a seed are connected, each of them has a neighbour closer to the seed which it also takes.
+// They are left without a seed and then taken back from the seeds of the cells around them.
+void SeedField::removeSeed(int seed, std::vector<int>& changed){
+    checkCell(seed);
+    if (!isSeed(seed)){
+        throw std::invalid_argument("SeedField::removeSeed: cell is not a seed");
+    }
+    region.clear();
+    region.push_back(seed);
+    nearest[seed] = noSeed;
+    for (size_t i = 0; i < region.size(); i++){
+        forNeighbours(region[i], [&](int neighbour){
+            if (nearest[neighbour] == seed){
+                nearest[neighbour] = noSeed;
+                region.push_back(neighbour);
+            }
+        });
+    }
+    changed.insert(changed.end(), region.begin(), region.end());
+
+    queue.clear();
+    for (int cell : region){
+        forNeighbours(cell, [&](int neighbour){
+            int other = nearest[neighbour];
+            if (other != noSeed){
+                queue.push(distance(cell, other), {cell, other});
+            }
+        });
+    }
+    spread(changed);
+}
+
+long long SeedField::distance(int cell, int seed) const{
+    long long dx = std::abs(cell % width - seed % width);
+    long long dy = std::abs(cell / width - seed / width);
+    return metric == Metric::manhattan ? dx + dy : std::max(dx, dy);
+}
+
+bool SeedField::improves(int cell, int seed) const{
+    int current = nearest[cell];
+    if (current == noSeed){
+        return true;
+    }
+    long long distanceToSeed = distance(cell, seed);
+    long long distanceToCurrent = distance(cell, current);
+    return distanceToSeed < distanceToCurrent || (distanceToSeed == distanceToCurrent && seed < current);
+}
+
+void SeedField::checkCell(int cell) const{
+    if (cell < 0 || cell >= static_cast<int>(nearest.size())){
+        throw std::out_of_range("SeedField: cell is out of range");
+    }
+}
+
+template <typename Visitor>
+void SeedField::forNeighbours(int cell, Visitor&& visitor) const{
+    int x = cell % width;
+    int y = cell / width;
+    for (int dy = -1; dy <= 1; dy++){
+        for (int dx = -1; dx <= 1; dx++){
+            if ((dx == 0 && dy == 0) || (metric == Metric::manhattan && dx != 0 && dy != 0)){
+                continue;
+            }
+            if (x + dx < 0 || y + dy < 0 || x + dx >= width || y + dy >= height){
+                continue;
+            }
+            visitor(cell + dy * width + dx);
+        }
+    }
+}
+
+// A candidate only moves to the neighbours one step further from its seed, so the keys never go down.
+// Every cell taken by a seed is reached through such a path of cells which the seed also takes.
+void SeedField::spread(std::vector<int>& changed){
+    while (!queue.empty()){
+        long long key = queue.popBucket(bucket);
+        for (const Candidate& candidate : bucket){
+            if (!improves(candidate.cell, candidate.seed)){
+                continue;
+            }
+            nearest[candidate.cell] = candidate.seed;
+            changed.push_back(candidate.cell);
+            forNeighbours(candidate.cell, [&](int neighbour){
+                if (distance(neighbour, candidate.seed) == key + 1){
+                    queue.push(key + 1, {neighbour, candidate.seed});
+                }
+            });
+        }
+    }
+}
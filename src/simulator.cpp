@@ -1,4 +1,5 @@
 #include "simulator.h"
+#include "step_recorder.h"
 
 #include <stdexcept>
 
@@ -8,14 +9,21 @@ void Simulator::start(){
     }
     status = SimulationStatus::RUNNING;
     steps = STARTING_STEP;
+    if (recorder)
+        recorder->clear();
     onStart();
+    if (recorder && !recorder->isStarted()){
+        finish();
+        throw std::logic_error("The simulator doesn't support recording, onStart didn't begin the recorder!");
+    }
+    if (observer)
+        observation.reset(getChangedCells());
 }
 
 bool Simulator::step(){
     if (status != SimulationStatus::RUNNING)
         throw std::logic_error("Can't step, the status is not RUNNING!");
-    steps++;
-    onStep();
+    runStep();
     return isRunning();
 }
 
@@ -34,6 +42,58 @@ void Simulator::reset(){
     onReset();
 }
 
+void Simulator::runToCompletion(){
+    if (status == SimulationStatus::INIT){
+        start();
+    } else if (status != SimulationStatus::RUNNING){
+        throw std::logic_error("Can't run, the status is not INIT or RUNNING!");
+    }
+    if (!isRunning())
+        return;
+    onRun();
+    if (isRunning())
+        throw std::logic_error("Simulation is still running after onRun!");
+}
+
+bool Simulator::stepUntil(Clock::time_point deadline){
+    if (status != SimulationStatus::RUNNING)
+        throw std::logic_error("Can't step, the status is not RUNNING!");
+    onStepUntil(deadline);
+    if (observer)
+        observation.pause();
+    return isRunning();
+}
+
+void Simulator::onRun(){
+    while (isRunning()){
+        runStep();
+    }
+}
+
+void Simulator::onStepUntil(Clock::time_point deadline){
+    do{
+        runStep();
+    } while (isRunning() && Clock::now() < deadline);
+}
+
+void Simulator::runStep(){
+    beginStep();
+    steps++;
+    onStep();
+    if (recorder)
+        recorder->endSteps(1);
+    if (observer)
+        observation.end(*observer, steps, getChangedCells(), getFrontierSize());
+}
+
+void Simulator::addSteps(long long count){
+    steps += count;
+    if (recorder)
+        recorder->endSteps(count);
+    if (observer)
+        observation.end(*observer, steps, getChangedCells(), getFrontierSize());
+}
+
 long long Simulator::getStep() const{
     return steps;
 }
@@ -41,3 +101,19 @@ long long Simulator::getStep() const{
 SimulationStatus Simulator::getStatus() const{
     return status;
 }
+
+void Simulator::setRecorder(StepRecorder* recorder){
+    if (status != SimulationStatus::INIT)
+        throw std::logic_error("Can't set the recorder, the status is not INIT!");
+    this->recorder = recorder;
+}
+
+void Simulator::setObserver(SimulatorObserver* observer){
+    this->observer = observer;
+    if (observer)
+        observation.reset(getChangedCells());
+}
+
+SimulatorObserver* Simulator::getObserver() const{
+    return observer;
+}
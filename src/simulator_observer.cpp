@@ -0,0 +1,47 @@
+#include "simulator_observer.h"
+
+void StepObservation::reset(long long changedCells){
+    begun = false;
+    paused = false;
+    startCells = changedCells;
+    elapsed = Clock::duration::zero();
+    segmentStart = Clock::now();
+}
+
+void StepObservation::begin(SimulatorObserver& observer, long long step, long long changedCells, long long frontierSize){
+    if (begun){
+        if (paused){
+            paused = false;
+            segmentStart = Clock::now();
+        }
+        return;
+    }
+    begun = true;
+    startCells = changedCells;
+    elapsed = Clock::duration::zero();
+    observer.onStepBegin(step, frontierSize);
+    segmentStart = Clock::now();
+}
+
+void StepObservation::pause(){
+    if (begun && !paused){
+        elapsed += Clock::now() - segmentStart;
+        paused = true;
+    }
+}
+
+void StepObservation::end(SimulatorObserver& observer, long long step, long long changedCells, long long frontierSize){
+    Clock::time_point now = Clock::now();
+    if (!paused){
+        elapsed += now - segmentStart;
+    }
+    StepProfile profile{
+        step,
+        changedCells - startCells,
+        frontierSize,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+    };
+    reset(changedCells);
+    observer.onStepEnd(profile);
+    segmentStart = Clock::now();
+}
@@ -0,0 +1,127 @@
+#include "stage_executor.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <optional>
+
+void StageHandle::cancel(){
+    stopSource.request_stop();
+}
+
+bool StageHandle::isCancelRequested() const{
+    return stopSource.stop_requested();
+}
+
+std::stop_token StageHandle::getStopToken() const{
+    return stopSource.get_token();
+}
+
+bool StageHandle::valid() const{
+    return future.valid();
+}
+
+void StageHandle::wait() const{
+    if (!future.valid()){
+        throw std::logic_error("Stage handle has no result");
+    }
+    future.wait();
+}
+
+StageResult StageHandle::get(){
+    if (!future.valid()){
+        throw std::logic_error("Stage handle has no result");
+    }
+    return future.get();
+}
+
+StageExecutor::StageExecutor(size_t threadCount){
+    threadCount = std::max<size_t>(threadCount, 1);
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++){
+        workers.emplace_back(&StageExecutor::workerLoop, this);
+    }
+}
+
+StageExecutor::~StageExecutor(){
+    std::deque<Job> abandoned;
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+        abandoned.swap(queue);
+    }
+    wakeUp.notify_all();
+    for (std::thread& worker : workers){
+        worker.join();
+    }
+    for (Job& job : abandoned){
+        Generator<StageProgress> dropped = std::move(job.stage);
+        job.promise.set_value(StageResult::cancelled);
+    }
+}
+
+size_t StageExecutor::size() const{
+    return workers.size();
+}
+
+StageHandle StageExecutor::submit(Generator<StageProgress> stage, ProgressCallback onProgress){
+    std::stop_source stopSource;
+    std::promise<StageResult> promise;
+    StageHandle handle(promise.get_future(), stopSource);
+    {
+        std::lock_guard lock(mutex);
+        if (stopping){
+            throw std::logic_error("Stage executor is stopping");
+        }
+        queue.push_back(Job{std::move(stage), std::move(onProgress), std::move(promise), stopSource.get_token()});
+    }
+    wakeUp.notify_one();
+    return handle;
+}
+
+void StageExecutor::workerLoop(){
+    while (true){
+        std::optional<Job> job;
+        {
+            std::unique_lock lock(mutex);
+            wakeUp.wait(lock, [this]{
+                return stopping || !queue.empty();
+            });
+            if (stopping){
+                return;
+            }
+            job.emplace(std::move(queue.front()));
+            queue.pop_front();
+        }
+        run(*job);
+    }
+}
+
+void StageExecutor::run(Job& job){
+    StageResult result = StageResult::completed;
+    std::exception_ptr failure;
+    try{
+        while (true){
+            if (job.stopToken.stop_requested() || stopping){
+                result = StageResult::cancelled;
+                break;
+            }
+            if (!job.stage.next()){
+                break;
+            }
+            if (job.onProgress){
+                job.onProgress(job.stage.value());
+            }
+        }
+    } catch (...){
+        failure = std::current_exception();
+    }
+    // The frame may still refer to the objects of the stage, it goes before the waiting side is released
+    {
+        Generator<StageProgress> dropped = std::move(job.stage);
+    }
+    if (failure){
+        job.promise.set_exception(failure);
+    } else{
+        job.promise.set_value(result);
+    }
+}
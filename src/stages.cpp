@@ -0,0 +1,18 @@
+#include "stages.h"
+
+Generator<StageProgress> stages::simulate(Simulator& simulator){
+    if (simulator.isInitialized())
+        simulator.start();
+    while (simulator.isRunning()){
+        simulator.step();
+        co_yield StageProgress{StagePhase::simulate, simulator.getStep()};
+    }
+}
+
+Generator<StageProgress> stages::chain(std::vector<Generator<StageProgress>> stages){
+    for (Generator<StageProgress>& stage : stages){
+        while (stage.next()){
+            co_yield stage.value();
+        }
+    }
+}
@@ -0,0 +1,144 @@
+#include "step_recorder.h"
+
+#include <algorithm>
+#include <iterator>
+
+StepRecorder::StepRecorder(double keyframeSpacing) : keyframeSpacing(keyframeSpacing){
+    if (!(keyframeSpacing > 0.0)){
+        throw std::invalid_argument("StepRecorder: keyframe spacing must be positive");
+    }
+}
+
+void StepRecorder::begin(int width, int height, std::function<int(int)> readCell){
+    if (width < 0 || height < 0){
+        throw std::invalid_argument("StepRecorder::begin: size can't be negative");
+    }
+    this->width = width;
+    this->height = height;
+    this->readCell = std::move(readCell);
+    deltas.clear();
+    stepOffsets.assign(1, 0);
+    keyframes.clear();
+    lastCell = 0;
+    lastValue = 0;
+    addKeyframe();
+}
+
+void StepRecorder::clear(){
+    width = 0;
+    height = 0;
+    readCell = nullptr;
+    deltas.clear();
+    stepOffsets.clear();
+    keyframes.clear();
+    changesSinceKeyframe = 0;
+}
+
+void StepRecorder::endSteps(long long count){
+    if (!isStarted()){
+        throw std::logic_error("StepRecorder: recording was not started");
+    }
+    for (long long i = 0; i < count; i++){
+        stepOffsets.push_back(deltas.size());
+        lastCell = 0;
+        lastValue = 0;
+        if (changesSinceKeyframe > 0 && changesSinceKeyframe >= keyframeSpacing * width * height){
+            addKeyframe();
+        }
+    }
+}
+
+bool StepRecorder::isStarted() const{
+    return !stepOffsets.empty();
+}
+
+long long StepRecorder::getStepCount() const{
+    return isStarted() ? static_cast<long long>(stepOffsets.size()) - 1 : 0;
+}
+
+int StepRecorder::getWidth() const{
+    return width;
+}
+
+int StepRecorder::getHeight() const{
+    return height;
+}
+
+size_t StepRecorder::getByteSize() const{
+    size_t size = deltas.size() + stepOffsets.size() * sizeof(size_t);
+    for (const Keyframe& keyframe : keyframes){
+        size += keyframe.runs.size() + sizeof(Keyframe);
+    }
+    return size;
+}
+
+void StepRecorder::seek(long long step, std::vector<int>& cells) const{
+    checkStep(step);
+    auto keyframe = std::prev(std::upper_bound(keyframes.begin(), keyframes.end(), step, [](long long step, const Keyframe& keyframe){
+        return step < keyframe.step;
+    }));
+    cells.resize(static_cast<size_t>(width) * height);
+    size_t position = 0;
+    size_t cell = 0;
+    while (position < keyframe->runs.size()){
+        int value = static_cast<int>(unzigzag(readVarint(keyframe->runs, position)));
+        size_t length = readVarint(keyframe->runs, position);
+        std::fill_n(cells.begin() + cell, length, value);
+        cell += length;
+    }
+    for (long long next = keyframe->step + 1; next <= step; next++){
+        applyStep(next, cells);
+    }
+}
+
+void StepRecorder::applyStep(long long step, std::vector<int>& cells) const{
+    checkStep(step);
+    if (step == 0){
+        return;
+    }
+    size_t position = stepOffsets[step - 1];
+    size_t end = stepOffsets[step];
+    long long cell = 0;
+    long long value = 0;
+    while (position < end){
+        cell += unzigzag(readVarint(deltas, position));
+        value += unzigzag(readVarint(deltas, position));
+        cells[cell] = static_cast<int>(value);
+    }
+}
+
+uint64_t StepRecorder::readVarint(const std::vector<uint8_t>& bytes, size_t& position){
+    uint64_t value = 0;
+    int shift = 0;
+    while (bytes[position] & 0x80){
+        value |= static_cast<uint64_t>(bytes[position++] & 0x7f) << shift;
+        shift += 7;
+    }
+    value |= static_cast<uint64_t>(bytes[position++]) << shift;
+    return value;
+}
+
+void StepRecorder::addKeyframe(){
+    Keyframe keyframe{getStepCount(), {}};
+    int cellCount = width * height;
+    int cell = 0;
+    while (cell < cellCount){
+        int value = readCell(cell);
+        int runEnd = cell + 1;
+        while (runEnd < cellCount && readCell(runEnd) == value){
+            runEnd++;
+        }
+        writeVarint(keyframe.runs, zigzag(value));
+        writeVarint(keyframe.runs, runEnd - cell);
+        cell = runEnd;
+    }
+    keyframe.runs.shrink_to_fit();
+    keyframes.push_back(std::move(keyframe));
+    changesSinceKeyframe = 0;
+}
+
+void StepRecorder::checkStep(long long step) const{
+    if (!isStarted() || step < 0 || step > getStepCount()){
+        throw std::out_of_range("StepRecorder: step was not recorded");
+    }
+}
@@ -0,0 +1,117 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threadCount){
+    threadCount = std::max<size_t>(threadCount, 1);
+    workers.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; i++){
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (std::thread& worker : workers){
+        worker.join();
+    }
+}
+
+ThreadPool &ThreadPool::instance(){
+    static ThreadPool threadPool;
+    return threadPool;
+}
+
+size_t ThreadPool::size() const{
+    return workers.size() + 1;
+}
+
+size_t ThreadPool::getChunkCount(size_t count) const{
+    return std::min(count, size());
+}
+
+size_t ThreadPool::chunkBegin(size_t count, size_t chunks, size_t chunk){
+    return count * chunk / chunks;
+}
+
+void ThreadPool::parallelFor(size_t count, const ChunkTask& task){
+    size_t chunks = getChunkCount(count);
+    if (chunks == 0){
+        return;
+    }
+    if (chunks == 1){
+        task(0, 0, count);
+        return;
+    }
+    std::lock_guard submitLock(submitMutex);
+    {
+        std::unique_lock lock(mutex);
+        // A worker may still be leaving the previous job
+        done.wait(lock, [this]{
+            return activeWorkers == 0;
+        });
+        this->task = &task;
+        this->count = count;
+        chunkCount = chunks;
+        nextChunk = 0;
+        finishedChunks = 0;
+        failure = nullptr;
+        generation++;
+    }
+    wakeUp.notify_all();
+    runChunks();
+
+    std::unique_lock lock(mutex);
+    done.wait(lock, [this]{
+        return finishedChunks == chunkCount && activeWorkers == 0;
+    });
+    this->task = nullptr;
+    if (failure){
+        std::rethrow_exception(failure);
+    }
+}
+
+void ThreadPool::workerLoop(){
+    size_t seenGeneration = 0;
+    while (true){
+        {
+            std::unique_lock lock(mutex);
+            wakeUp.wait(lock, [&]{
+                return stopping || generation != seenGeneration;
+            });
+            if (stopping){
+                return;
+            }
+            seenGeneration = generation;
+            activeWorkers++;
+        }
+        runChunks();
+        {
+            std::lock_guard lock(mutex);
+            activeWorkers--;
+        }
+        done.notify_all();
+    }
+}
+
+void ThreadPool::runChunks(){
+    size_t chunk;
+    while ((chunk = nextChunk.fetch_add(1)) < chunkCount){
+        try{
+            (*task)(chunk, chunkBegin(count, chunkCount, chunk), chunkBegin(count, chunkCount, chunk + 1));
+        } catch (...){
+            std::lock_guard lock(mutex);
+            if (!failure){
+                failure = std::current_exception();
+            }
+        }
+        if (finishedChunks.fetch_add(1) + 1 == chunkCount){
+            std::lock_guard lock(mutex);
+            done.notify_all();
+        }
+    }
+}
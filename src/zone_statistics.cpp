@@ -0,0 +1,94 @@
+#include "zone_statistics.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+ZoneStatistics::ZoneStatistics(int width, int height) : width(width), height(height){}
+
+void ZoneStatistics::change(Identifiable from, Identifiable to, int x, int y){
+    if (from == to){
+        return;
+    }
+    if (from != Identifiable::nullID){
+        remove(from, x, y);
+    }
+    if (to != Identifiable::nullID){
+        add(to, x, y);
+    }
+}
+
+void ZoneStatistics::add(Identifiable zoneID, int x, int y){
+    Zone& zone = zones[zoneID];
+    if (zone.rowCounts.empty()){
+        zone.rowCounts.resize(height);
+        zone.columnCounts.resize(width);
+    }
+    if (zone.area == 0){
+        zone.bounds = {{x, y}, {x, y}};
+    } else{
+        zone.bounds.min.x = std::min(zone.bounds.min.x, x);
+        zone.bounds.min.y = std::min(zone.bounds.min.y, y);
+        zone.bounds.max.x = std::max(zone.bounds.max.x, x);
+        zone.bounds.max.y = std::max(zone.bounds.max.y, y);
+    }
+    zone.area++;
+    zone.sumX += x;
+    zone.sumY += y;
+    zone.rowCounts[y]++;
+    zone.columnCounts[x]++;
+}
+
+void ZoneStatistics::remove(Identifiable zoneID, int x, int y){
+    auto it = zones.find(zoneID);
+    if (it == zones.end() || it->second.area == 0){
+        throw std::logic_error("ZoneStatistics: removing a tile from an empty zone " + zoneID.toString());
+    }
+    Zone& zone = it->second;
+    zone.area--;
+    zone.sumX -= x;
+    zone.sumY -= y;
+    zone.rowCounts[y]--;
+    zone.columnCounts[x]--;
+    if (zone.area == 0){
+        return;
+    }
+    ZoneBounds& bounds = zone.bounds;
+    while (zone.rowCounts[bounds.min.y] == 0) bounds.min.y++;
+    while (zone.rowCounts[bounds.max.y] == 0) bounds.max.y--;
+    while (zone.columnCounts[bounds.min.x] == 0) bounds.min.x++;
+    while (zone.columnCounts[bounds.max.x] == 0) bounds.max.x--;
+}
+
+void ZoneStatistics::clear(){
+    zones.clear();
+}
+
+bool ZoneStatistics::contains(Identifiable zone) const{
+    auto it = zones.find(zone);
+    return it != zones.end() && it->second.area > 0;
+}
+
+int ZoneStatistics::getArea(Identifiable zone) const{
+    auto it = zones.find(zone);
+    return it == zones.end() ? 0 : it->second.area;
+}
+
+ZoneBounds ZoneStatistics::getBounds(Identifiable zone) const{
+    return getZone(zone).bounds;
+}
+
+DoubleVector2 ZoneStatistics::getCentroid(Identifiable zoneID) const{
+    const Zone& zone = getZone(zoneID);
+    return {
+        static_cast<double>(zone.sumX) / zone.area,
+        static_cast<double>(zone.sumY) / zone.area
+    };
+}
+
+const ZoneStatistics::Zone &ZoneStatistics::getZone(Identifiable zoneID) const{
+    auto it = zones.find(zoneID);
+    if (it == zones.end() || it->second.area == 0){
+        throw std::out_of_range("ZoneStatistics: zone " + zoneID.toString() + " has no tiles");
+    }
+    return it->second;
+}